@@ -111,6 +111,39 @@ CommandLine::CommandLine(int argc, const char** argv) {
           }
         }
       }
+    else if(arg=="-tickrate") {
+      ++i;
+      if(i<argc) {
+        try {
+          tickRate = uint32_t(std::stoul(std::string(argv[i])));
+          tickRate = std::min(tickRate, 1000u);
+          }
+        catch (const std::exception& e) {
+          Log::i("failed to read logic tick rate: \"", std::string(argv[i]), "\"");
+          }
+        }
+      }
+    else if(arg=="-headless") {
+      ++i;
+      if(i<argc) {
+        try {
+          headlessMin = uint32_t(std::stoul(std::string(argv[i])));
+          }
+        catch (const std::exception& e) {
+          Log::i("failed to read headless simulation time: \"", std::string(argv[i]), "\"");
+          }
+        }
+      }
+    else if(arg=="-record") {
+      ++i;
+      if(i<argc)
+        recordFile = argv[i];
+      }
+    else if(arg=="-replay") {
+      ++i;
+      if(i<argc)
+        replayFile = argv[i];
+      }
     else if(arg=="-gi") {
       ++i;
       if(i<argc)
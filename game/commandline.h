@@ -44,7 +44,12 @@ class CommandLine {
     bool                doForceG2()        const { return forceG2;      }
     bool                doForceG2NR()      const { return forceG2NR;    }
     uint32_t            fxaaPreset()       const { return fxaaPresetId; }
+    uint32_t            logicTickRate()    const { return tickRate;     }
     std::string_view    defaultSave()      const { return saveDef;      }
+    bool                isHeadless()       const { return headlessMin>0; }
+    uint32_t            headlessMinutes()  const { return headlessMin;  }
+    const std::string&  recordPath()       const { return recordFile;   }
+    const std::string&  replayPath()       const { return replayFile;   }
 
     std::string         wrldDef;
 
@@ -56,6 +61,7 @@ class CommandLine {
     std::u16string      gscript;
     std::u16string      gcutscene;
     std::string         saveDef;
+    std::string         recordFile, replayFile;
     bool                devmode      = false;
     bool                noMenu       = false;
     bool                isWindow     = false;
@@ -73,5 +79,7 @@ class CommandLine {
     bool                forceG2      = false;
     bool                forceG2NR    = false;
     uint32_t            fxaaPresetId = 0;
+    uint32_t            tickRate     = 0;
+    uint32_t            headlessMin  = 0;
   };
 
@@ -7,6 +7,7 @@
 #include <cctype>
 
 #include "utils/string_frm.h"
+#include "utils/profiler.h"
 #include "worldstatestorage.h"
 #include "world/objects/npc.h"
 #include "world/world.h"
@@ -301,6 +302,7 @@ void GameSession::setTime(gtime t) {
   }
 
 void GameSession::tick(uint64_t dt) {
+  Profiler::Zone zone("GameSession::tick");
   wrld->scaleTime(dt);
   ticks+=dt;
 
@@ -0,0 +1,108 @@
+#include "inputrecord.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include "playercontrol.h"
+
+using namespace Tempest;
+
+static_assert(sizeof(InputRecord::Event)==16);
+
+void InputRecord::clear() {
+  events.clear();
+  at = 0;
+  }
+
+bool InputRecord::load(const std::string& file) {
+  clear();
+  try {
+    RFile fin(file.c_str());
+    uint32_t version = 0, count = 0;
+    if(fin.read(&version,sizeof(version))!=sizeof(version) || version!=FileVersion)
+      return false;
+    if(fin.read(&count,sizeof(count))!=sizeof(count))
+      return false;
+    events.resize(count);
+    if(fin.read(events.data(),events.size()*sizeof(Event))!=events.size()*sizeof(Event)) {
+      clear();
+      return false;
+      }
+    }
+  catch(...) {
+    clear();
+    return false;
+    }
+  return true;
+  }
+
+void InputRecord::save(const std::string& file) const {
+  try {
+    WFile fout(file.c_str());
+    const uint32_t version = FileVersion;
+    const uint32_t count   = uint32_t(events.size());
+    fout.write(&version,sizeof(version));
+    fout.write(&count,  sizeof(count));
+    fout.write(events.data(),events.size()*sizeof(Event));
+    }
+  catch(...) {
+    Log::e("unable to write input record: \"",file,"\"");
+    }
+  }
+
+void InputRecord::keyPressed(KeyCodec::Action a, KeyEvent::KeyType key, KeyCodec::Mapping mapping) {
+  Event e;
+  e.type    = KeyPressed;
+  e.action  = uint8_t(a);
+  e.mapping = uint8_t(mapping);
+  e.key     = uint32_t(key);
+  events.push_back(e);
+  }
+
+void InputRecord::keyReleased(KeyCodec::Action a, KeyCodec::Mapping mapping) {
+  Event e;
+  e.type    = KeyReleased;
+  e.action  = uint8_t(a);
+  e.mapping = uint8_t(mapping);
+  events.push_back(e);
+  }
+
+void InputRecord::rotate(Type axis, float dAngle) {
+  Event e;
+  e.type  = axis;
+  e.value = dAngle;
+  events.push_back(e);
+  }
+
+void InputRecord::tick(uint64_t dt) {
+  if(dt==0)
+    return;
+  Event e;
+  e.type = Tick;
+  e.dt   = uint32_t(dt);
+  events.push_back(e);
+  }
+
+uint64_t InputRecord::replay(PlayerControl& player) {
+  while(at<events.size()) {
+    auto& e = events[at];
+    ++at;
+    switch(e.type) {
+      case KeyPressed:
+        player.onKeyPressed(KeyCodec::Action(e.action),KeyEvent::KeyType(e.key),KeyCodec::Mapping(e.mapping));
+        break;
+      case KeyReleased:
+        player.onKeyReleased(KeyCodec::Action(e.action),KeyCodec::Mapping(e.mapping));
+        break;
+      case RotateX:
+        player.onRotateMouse(e.value);
+        break;
+      case RotateY:
+        player.onRotateMouseDy(e.value);
+        break;
+      case Tick:
+        return e.dt;
+      }
+    }
+  return 0;
+  }
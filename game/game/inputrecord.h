@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Tempest/Event>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "utils/keycodec.h"
+
+class PlayerControl;
+
+// player input, as seen by PlayerControl, aligned to logic ticks
+class InputRecord final {
+  public:
+    enum Type : uint8_t {
+      KeyPressed,
+      KeyReleased,
+      RotateX,
+      RotateY,
+      Tick,
+      };
+
+    struct Event {
+      Type     type    = Tick;
+      uint8_t  action  = 0;
+      uint8_t  mapping = 0;
+      uint8_t  padd    = 0;
+      uint32_t key     = 0;
+      float    value   = 0;
+      uint32_t dt      = 0;
+      };
+
+    void     clear();
+    bool     load(const std::string& file);
+    void     save(const std::string& file) const;
+    bool     isEmpty() const { return events.empty(); }
+
+    void     keyPressed (KeyCodec::Action a, Tempest::KeyEvent::KeyType key, KeyCodec::Mapping mapping);
+    void     keyReleased(KeyCodec::Action a, KeyCodec::Mapping mapping);
+    void     rotate     (Type axis, float dAngle);
+    void     tick       (uint64_t dt);
+
+    // feeds input up to next tick into player; returns dt of that tick, or 0 at end of record
+    uint64_t replay(PlayerControl& player);
+
+  private:
+    static constexpr uint32_t FileVersion = 1;
+
+    std::vector<Event> events;
+    size_t             at = 0;
+  };
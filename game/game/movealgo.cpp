@@ -330,6 +330,19 @@ void MoveAlgo::tickSwim(uint64_t dt) {
   tryMove(dp.x,dp.y,dp.z);
   }
 
+void MoveAlgo::prefetch(uint64_t dt) {
+  // warm up ray caches for tickRun; NoFlag - target of fight-move may be in the middle of it's own tick
+  if(isInAir() || isSwim() || isDive() || isClimb() || npc.interactive()!=nullptr)
+    return;
+  const auto  dp            = npcMoveSpeed(dt,NoFlag);
+  const auto  pos           = npc.position();
+  const float fallThreshold = stepHeight();
+
+  bool valid = false;
+  dropRay (pos+dp+Tempest::Vec3(0,fallThreshold,0), valid);
+  waterRay(pos+dp);
+  }
+
 bool MoveAlgo::tickRun(uint64_t dt, MvFlags moveFlg) {
   const auto  dp            = npcMoveSpeed(dt,moveFlg);
   const auto  pos           = npc.position();
@@ -42,6 +42,7 @@ class MoveAlgo final {
     void    save(Serialize& fout) const;
 
     void    tick(uint64_t dt, MvFlags fai=NoFlag);
+    void    prefetch(uint64_t dt);
 
     void    multSpeed(float s){ mulSpeed=s; }
     void    clearSpeed();
@@ -8,6 +8,7 @@
 #include "world/world.h"
 #include "ui/dialogmenu.h"
 #include "ui/inventorymenu.h"
+#include "inputrecord.h"
 #include "gothic.h"
 
 PlayerControl::PlayerControl(DialogMenu& dlg, InventoryMenu &inv)
@@ -46,6 +47,9 @@ void PlayerControl::setTarget(Npc *other) {
   }
 
 void PlayerControl::onKeyPressed(KeyCodec::Action a, Tempest::KeyEvent::KeyType key, KeyCodec::Mapping mapping) {
+  if(record!=nullptr)
+    record->keyPressed(a,key,mapping);
+
   auto       w    = Gothic::inst().world();
   auto       c    = Gothic::inst().camera();
   auto       pl   = w  ? w->player() : nullptr;
@@ -200,6 +204,8 @@ void PlayerControl::onKeyPressed(KeyCodec::Action a, Tempest::KeyEvent::KeyType
   }
 
 void PlayerControl::onKeyReleased(KeyCodec::Action a, KeyCodec::Mapping mapping) {
+  if(record!=nullptr)
+    record->keyReleased(a,mapping);
   ctrl[a] = false;
 
   handleMovementAction(KeyCodec::ActionMapping{a, mapping}, false);
@@ -248,11 +254,15 @@ bool PlayerControl::isPressed(KeyCodec::Action a) const {
   }
 
 void PlayerControl::onRotateMouse(float dAngle) {
+  if(record!=nullptr)
+    record->rotate(InputRecord::RotateX,dAngle);
   dAngle = std::max(-40.f,std::min(dAngle,40.f));
   rotMouse += dAngle*0.3f;
   }
 
 void PlayerControl::onRotateMouseDy(float dAngle) {
+  if(record!=nullptr)
+    record->rotate(InputRecord::RotateY,dAngle);
   dAngle = std::max(-100.f,std::min(dAngle,100.f));
   rotMouseY += dAngle*0.2f;
   }
@@ -537,7 +547,18 @@ bool PlayerControl::tickCameraMove(uint64_t dt) {
   return true;
   }
 
+void PlayerControl::tickLogic(uint64_t dt) {
+  dlg.tick(dt);
+  inv.tick(dt);
+  Gothic::inst().tick(dt);
+  tickFocus();
+  tickMove(dt);
+  Gothic::inst().updateAnimation(dt);
+  }
+
 bool PlayerControl::tickMove(uint64_t dt) {
+  if(record!=nullptr)
+    record->tick(dt);
   auto w = Gothic::inst().world();
   if(w==nullptr)
     return false;
@@ -14,6 +14,7 @@ class Npc;
 class Item;
 class Camera;
 class Gothic;
+class InputRecord;
 
 class PlayerControl final {
   public:
@@ -45,6 +46,10 @@ class PlayerControl final {
 
     bool  tickMove(uint64_t dt);
     bool  tickCameraMove(uint64_t dt);
+    // single logic step: same order in window and headless runner, for replays to match
+    void  tickLogic(uint64_t dt);
+
+    void  setRecord(InputRecord* r) { record = r; }
 
   private:
     enum WeaponAction : uint8_t {
@@ -154,6 +159,7 @@ class PlayerControl final {
 
     DialogMenu&    dlg;
     InventoryMenu& inv;
+    InputRecord*   record = nullptr;
 
     void           setupSettings();
     bool           canInteract() const;
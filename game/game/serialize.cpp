@@ -62,7 +62,6 @@ Serialize::Serialize(Tempest::ODevice& fout) : fout(&fout) {
   impl.m_pWrite           = Serialize::writeFunc;
   impl.m_pIO_opaque       = this;
   impl.m_zip_type         = MZ_ZIP_TYPE_USER;
-  mz_zip_writer_init_v2(&impl, 0, 0);
   }
 
 Serialize::Serialize(Tempest::IDevice& fin) : fin(&fin) {
@@ -72,18 +71,138 @@ Serialize::Serialize(Tempest::IDevice& fin) : fin(&fin) {
   impl.m_pRead            = Serialize::readFunc;
   impl.m_pIO_opaque       = this;
   impl.m_zip_type         = MZ_ZIP_TYPE_USER;
-  mz_zip_reader_init(&impl, fin.size(), 0);
+  readPreamble();
+  }
+
+Serialize::Serialize(Snapshot& snap) : snap(&snap) {
+  entryName.reserve(256);
   }
 
 Serialize::~Serialize() {
   closeEntry();
   if(fout!=nullptr) {
+    flushDeflate(0);
+    initWriter();
     mz_zip_writer_finalize_archive(&impl);
     mz_zip_writer_end(&impl);
     //Tempest::Log::d("save time = ", Tempest::Application::tickCount()-time0);
     }
   }
 
+void Serialize::writeSnapshot(Tempest::ODevice& fout, const Snapshot& snap) {
+  Serialize s(fout);
+  for(auto& i:snap.entries)
+    s.addEntry(i.name.c_str(), i.data.data(), i.data.size());
+  }
+
+std::vector<uint8_t> Serialize::Snapshot::bytes() const {
+  std::vector<uint8_t> ret;
+  for(auto& i:entries) {
+    if(i.data.empty())
+      continue;
+    const uint64_t sz = i.data.size();
+    auto           p  = reinterpret_cast<const uint8_t*>(&sz);
+    ret.insert(ret.end(), i.name.begin(), i.name.end());
+    ret.push_back(0);
+    ret.insert(ret.end(), p, p+sizeof(sz));
+    ret.insert(ret.end(), i.data.begin(), i.data.end());
+    }
+  return ret;
+  }
+
+const char Serialize::preambleTag[4] = {'O','G','S','V'};
+
+bool Serialize::isPreamble(std::string_view name) {
+  // kept uncompressed in front of archive: save-slot list reads them without zip directory
+  return name=="header" || name=="preview.png";
+  }
+
+bool Serialize::isCompressible(std::string_view name) {
+  if(isPreamble(name))
+    return false;
+  // payload is zip/png already
+  auto ext = name.size()>4 ? name.substr(name.size()-4) : std::string_view();
+  return ext!=".zip" && ext!=".png";
+  }
+
+void Serialize::readPreamble() {
+  auto read = [this](void* dst, size_t sz) {
+    size_t rd = fin->read(dst,sz);
+    curOffset += rd;
+    return rd==sz;
+    };
+
+  char magic[4] = {};
+  if(!read(magic,sizeof(magic)) || std::memcmp(magic,preambleTag,sizeof(magic))!=0)
+    return;
+
+  uint32_t count = 0;
+  if(!read(&count,sizeof(count)))
+    return;
+
+  Snapshot ret;
+  for(uint32_t i=0; i<count; ++i) {
+    Snapshot::Entry e;
+    uint16_t nlen = 0;
+    uint32_t sz   = 0;
+    if(!read(&nlen,sizeof(nlen)))
+      return;
+    e.name.resize(nlen);
+    if(!read(e.name.data(),nlen) || !read(&sz,sizeof(sz)))
+      return;
+    e.data.resize(sz);
+    if(!read(e.data.data(),sz))
+      return;
+    ret.entries.push_back(std::move(e));
+    }
+  preamble = std::move(ret);
+  }
+
+void Serialize::initWriter() {
+  if(zipReady)
+    return;
+  zipReady = true;
+
+  // preamble: plain block in front of zip data, zip offsets are absolute so archive stays valid
+  uint64_t prefix = 0;
+  if(!preambleHold.empty()) {
+    std::vector<uint8_t> blk;
+    auto push = [&blk](const void* v, size_t sz) {
+      auto b = reinterpret_cast<const uint8_t*>(v);
+      blk.insert(blk.end(),b,b+sz);
+      };
+    const uint32_t count = uint32_t(preambleHold.size());
+    push(preambleTag,4);
+    push(&count,sizeof(count));
+    for(auto& i:preambleHold) {
+      const uint16_t nlen = uint16_t(i->name.size());
+      const uint32_t sz   = uint32_t(i->size);
+      push(&nlen,sizeof(nlen));
+      push(i->name.data(),nlen);
+      push(&sz,sizeof(sz));
+      push(i->src,sz);
+      }
+    prefix = fout->write(blk.data(),blk.size());
+    if(prefix!=blk.size())
+      throw std::runtime_error("unable to write game archive");
+    curOffset = prefix;
+    }
+
+  mz_zip_writer_init_v2(&impl, prefix, 0);
+
+  // keep preamble entries in zip directory as well
+  for(auto& i:preambleHold)
+    writeDeflate(*i);
+  preambleHold.clear();
+  }
+
+void Serialize::initReader() {
+  if(zipReady)
+    return;
+  zipReady = true;
+  mz_zip_reader_init(&impl, fin->size(), 0);
+  }
+
 std::string_view Serialize::worldName() const {
   if(ctx!=nullptr)
     return ctx->name();
@@ -91,22 +210,120 @@ std::string_view Serialize::worldName() const {
   }
 
 void Serialize::closeEntry() {
-  if(fout==nullptr)
+  if(!isWriting())
     return;
   if(entryBuf.empty())
     return;
 
-  mz_uint level  = entryBuf.size()>256 ? MZ_BEST_SPEED : MZ_NO_COMPRESSION;
-  mz_bool status = mz_zip_writer_add_mem(&impl, entryName.c_str(), entryBuf.data(), entryBuf.size(), level);
-  entryBuf .clear();
+  addEntry(entryName.c_str(), std::move(entryBuf));
+  entryBuf = std::vector<uint8_t>();
   entryName.clear();
+  }
+
+void Serialize::addEntry(const char* name, const void* data, size_t size) {
+  if(snap!=nullptr) {
+    auto  bytes = reinterpret_cast<const uint8_t*>(data);
+    snap->entries.push_back({name,std::vector<uint8_t>(bytes,bytes+size)});
+    return;
+    }
+
+  auto d = std::make_shared<Deflate>();
+  d->name = name;
+  d->src  = data;
+  d->size = size;
+  pushDeflate(std::move(d));
+  }
+
+void Serialize::addEntry(const char* name, std::vector<uint8_t>&& data) {
+  if(snap!=nullptr) {
+    snap->entries.push_back({name,std::move(data)});
+    return;
+    }
+
+  auto d = std::make_shared<Deflate>();
+  d->name = name;
+  d->data = std::move(data);
+  d->src  = d->data.data();
+  d->size = d->data.size();
+  pushDeflate(std::move(d));
+  }
+
+void Serialize::pushDeflate(std::shared_ptr<Deflate>&& d) {
+  if(d->size>256 && isCompressible(d->name)) {
+    deflateTasks.run([d]() { d->compress(); });
+    } else {
+    d->claimed.store(true);
+    d->ready.store(true);
+    }
+  deflateQueue.push_back(std::move(d));
+
+  // bound memory held by in-flight entries
+  flushDeflate(size_t(Workers::maxThreads())*2);
+  }
+
+void Serialize::flushDeflate(size_t maxInFlight) {
+  while(!deflateQueue.empty()) {
+    auto& front = *deflateQueue.front();
+    if(deflateQueue.size()>maxInFlight)
+      front.wait(); else
+    if(!front.ready.load())
+      break;
+
+    auto d = std::move(deflateQueue.front());
+    deflateQueue.pop_front();
+    if(!zipReady && isPreamble(d->name)) {
+      preambleHold.push_back(std::move(d));
+      continue;
+      }
+    initWriter();
+    writeDeflate(*d);
+    }
+  }
+
+void Serialize::writeDeflate(const Deflate& d) {
+  // fixed timestamp: same game state produces byte-identical archive
+  MZ_TIME_T mtime  = {};
+  mz_bool   status = MZ_FALSE;
+  if(d.comp!=nullptr) {
+    status = mz_zip_writer_add_mem_ex_v2(&impl, d.name.c_str(), d.comp, d.compSz, nullptr, 0,
+                                         mz_uint(MZ_BEST_SPEED) | MZ_ZIP_FLAG_COMPRESSED_DATA, d.size, d.crc,
+                                         &mtime, nullptr, 0, nullptr, 0);
+    } else {
+    status = mz_zip_writer_add_mem_ex_v2(&impl, d.name.c_str(), d.src, d.size, nullptr, 0,
+                                         MZ_NO_COMPRESSION, 0, 0,
+                                         &mtime, nullptr, 0, nullptr, 0);
+    }
   if(!status)
     throw std::runtime_error("unable to write entry in game archive");
   }
 
+Serialize::Deflate::~Deflate() {
+  mz_free(comp);
+  }
+
+void Serialize::Deflate::compress() {
+  // either worker task or writer thread, whoever comes first
+  if(claimed.exchange(true))
+    return;
+  // same parameters as mz_zip_writer_add_mem uses for MZ_BEST_SPEED
+  const int flags = int(tdefl_create_comp_flags_from_zip_params(MZ_BEST_SPEED, -15, MZ_DEFAULT_STRATEGY));
+  crc  = uint32_t(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const mz_uint8*>(src), size));
+  comp = tdefl_compress_mem_to_heap(src, size, &compSz, flags);
+
+  std::lock_guard<std::mutex> guard(sync);
+  ready.store(true);
+  done.notify_all();
+  }
+
+void Serialize::Deflate::wait() {
+  compress();
+  std::unique_lock<std::mutex> lck(sync);
+  done.wait(lck,[this](){ return ready.load(); });
+  }
+
 bool Serialize::implSetEntry(std::string_view fname) {
   size_t prefix = 0;
-  if(fout!=nullptr) {
+  if(isWriting()) {
     while(prefix<fname.size() && prefix<entryName.size()) {
       if(entryName[prefix]!=fname[prefix])
         break;
@@ -115,23 +332,29 @@ bool Serialize::implSetEntry(std::string_view fname) {
     }
   closeEntry();
   entryName = fname;
-  if(fout!=nullptr) {
+  if(isWriting()) {
     for(size_t i=prefix; i<entryName.size(); ++i) {
       if(entryName[i]=='/' && i+1<entryName.size()) {
         const char prev = entryName[i+1];
         entryName[i+1] = '\0';
         const auto it = outFileList.insert(entryName.c_str());
-        if(it.second) {
-          mz_bool status = mz_zip_writer_add_mem(&impl, entryName.c_str(), NULL, 0, MZ_NO_COMPRESSION);
-          if(!status)
-            throw std::runtime_error("unable to allocate entry in game archive");
-          }
+        if(it.second)
+          addEntry(entryName.c_str(), nullptr, 0);
         entryName[i+1] = prev;
         }
       }
     return true;
     }
   if(fin!=nullptr) {
+    readOffset = 0;
+    for(auto& i:preamble.entries) {
+      if(i.name==entryName) {
+        entryBuf = i.data;
+        return !entryBuf.empty();
+        }
+      }
+
+    initReader();
     mz_uint32 id = mz_uint32(-1);
     if(mz_zip_reader_locate_file_v2(&impl, entryName.c_str(), nullptr, 0, &id)) {
       mz_zip_archive_file_stat stat = {};
@@ -147,8 +370,21 @@ bool Serialize::implSetEntry(std::string_view fname) {
   return false;
   }
 
+bool Serialize::implHasEntry(std::string_view fname) {
+  if(fin==nullptr)
+    return false;
+  for(auto& i:preamble.entries)
+    if(i.name==fname)
+      return !i.data.empty();
+  initReader();
+  const std::string name(fname);
+  mz_uint32         id = mz_uint32(-1);
+  return mz_zip_reader_locate_file_v2(&impl, name.c_str(), nullptr, 0, &id);
+  }
+
 uint32_t Serialize::implDirectorySize(std::string_view e) {
   // Get and print information about each file in the archive.
+  initReader();
   uint32_t cnt = 0;
   for(mz_uint i = 0; i<mz_zip_reader_get_num_files(&impl); i++) {
     mz_zip_archive_file_stat stat = {};
@@ -172,6 +408,15 @@ void Serialize::writeBytes(const void* buf, size_t sz) {
   std::memcpy(&entryBuf[at],buf,sz);
   }
 
+void Serialize::appendSnapshot(const Snapshot& snap) {
+  for(auto& i:snap.entries) {
+    if(i.data.empty())
+      continue;
+    implSetEntry(i.name);
+    writeBytes(i.data.data(),i.data.size());
+    }
+  }
+
 void Serialize::readBytes(void* buf, size_t sz) {
   if(fin==nullptr || readOffset+sz>entryBuf.size())
     throw std::runtime_error("unable to read save-game file");
@@ -7,6 +7,7 @@
 #include <Tempest/Matrix4x4>
 
 #include <vector>
+#include <deque>
 #include <unordered_set>
 #include <cstdint>
 #include <type_traits>
@@ -21,6 +22,7 @@
 #include "gametime.h"
 #include "constants.h"
 #include "utils/string_frm.h"
+#include "utils/workers.h"
 
 class WayPoint;
 class Npc;
@@ -33,13 +35,26 @@ class SaveGameHeader;
 class Serialize {
   public:
     enum Version : uint16_t {
-      Current = 49
+      Current = 51
       };
+    // uncompressed in-memory copy of all entries, in order of writing
+    struct Snapshot {
+      struct Entry {
+        std::string          name;
+        std::vector<uint8_t> data;
+        };
+      std::vector<Entry> entries;
+      // flat copy of non-empty entries, to compare against a baseline
+      std::vector<uint8_t> bytes() const;
+      };
+
     Serialize(Tempest::ODevice& fout);
     Serialize(Tempest::IDevice&  fin);
-    Serialize(Serialize&&)=default;
+    Serialize(Snapshot& snap);
     ~Serialize();
 
+    static void writeSnapshot(Tempest::ODevice& fout, const Snapshot& snap);
+
     uint16_t version()              const { return wldVer; }
     void     setVersion(uint16_t v)       { wldVer = v;    }
     uint16_t globalVersion()        const { return curVer; }
@@ -51,6 +66,12 @@ class Serialize {
       return implSetEntry(s);
       }
 
+    template<class ... Args>
+    bool hasEntry(const Args& ... args) {
+      string_frm s(args...);
+      return implHasEntry(s);
+      }
+
     template<class ... Args>
     uint32_t directorySize(const Args& ... args) {
       string_frm s(args...);
@@ -63,6 +84,7 @@ class Serialize {
     // raw
     void writeBytes(const void* v,size_t sz);
     void readBytes (void* v,size_t sz);
+    void appendSnapshot(const Snapshot& snap);
 
     template<class ... Arg>
     void write(const Arg& ... a){
@@ -268,8 +290,43 @@ class Serialize {
     static size_t writeFunc(void *pOpaque, uint64_t file_ofs, const void *pBuf, size_t n);
     static size_t readFunc (void *pOpaque, uint64_t file_ofs, void *pBuf, size_t n);
 
+    // entry compressed on a worker thread; written to archive strictly in order
+    struct Deflate {
+      ~Deflate();
+      void                 compress();
+      void                 wait();
+
+      std::string          name;
+      std::vector<uint8_t> data;
+      const void*          src     = nullptr;
+      size_t               size    = 0;
+      void*                comp    = nullptr;
+      size_t               compSz  = 0;
+      uint32_t             crc     = 0;
+      std::atomic_bool     claimed{false};
+      std::atomic_bool     ready{false};
+      std::mutex           sync;
+      std::condition_variable done;
+      };
+
     void   closeEntry();
+    void   addEntry(const char* name, const void* data, size_t size);
+    void   addEntry(const char* name, std::vector<uint8_t>&& data);
+    void   pushDeflate(std::shared_ptr<Deflate>&& d);
+    void   flushDeflate(size_t maxInFlight);
+    void   writeDeflate(const Deflate& d);
+    bool   isWriting() const { return fout!=nullptr || snap!=nullptr; }
+    void   readPreamble();
+    void   initReader();
+    void   initWriter();
+
+    static bool isPreamble    (std::string_view name);
+    static bool isCompressible(std::string_view name);
+
+    static const char preambleTag[4];
+
     bool   implSetEntry(std::string_view e);
+    bool   implHasEntry(std::string_view e);
     uint32_t implDirectorySize(std::string_view e);
 
     uint16_t                 curVer = Version::Current;
@@ -286,5 +343,12 @@ class Serialize {
     uint64_t                 readOffset = 0;
     Tempest::ODevice*        fout      = nullptr;
     Tempest::IDevice*        fin       = nullptr;
+    Snapshot*                snap      = nullptr;
+    Snapshot                 preamble;
+    bool                     zipReady  = false;
+
+    std::vector<std::shared_ptr<Deflate>> preambleHold;
+    std::deque<std::shared_ptr<Deflate>>  deflateQueue;
+    Workers::TaskGroup                    deflateTasks;
   };
 
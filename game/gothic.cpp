@@ -2,7 +2,10 @@
 
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
+#include <Tempest/Application>
+#include <Tempest/File>
 
+#include <filesystem>
 #include <cstring>
 #include <cctype>
 
@@ -17,8 +20,10 @@
 
 #include "world/objects/npc.h"
 
+#include "game/serialize.h"
 #include "utils/fileutil.h"
 #include "utils/inifile.h"
+#include "utils/workers.h"
 
 #include "commandline.h"
 
@@ -216,6 +221,7 @@ Gothic::Gothic() {
   }
 
 Gothic::~Gothic() {
+  waitSave();
   instance = nullptr;
   }
 
@@ -462,6 +468,51 @@ void Gothic::startSave(Tempest::Texture2d&& tex,
   implStartLoadSave("",false,f);
   }
 
+bool Gothic::startSnapshotSave(std::string_view slot, std::string_view name, const Tempest::Pixmap& pm) {
+  if(game==nullptr || checkLoading()!=LoadState::Idle)
+    return false;
+
+  // only one background write at a time
+  waitSave();
+
+  auto time0 = Tempest::Application::tickCount();
+  auto snap  = std::make_shared<Serialize::Snapshot>();
+  try {
+    Serialize s(*snap);
+    game->save(s,name,pm);
+    }
+  catch(const std::exception& e) {
+    Tempest::Log::e("saving error: ", e.what());
+    return false;
+    }
+  Tempest::Log::d("save snapshot: ", Tempest::Application::tickCount()-time0, "ms");
+
+  // dedicated thread, not worker pool: write takes seconds and must not end up inside of some TaskGroup::wait
+  saveTh = std::thread([snap,slot=std::string(slot)]() noexcept {
+    Workers::setThreadName("Save thread");
+    // write to temporary file first: old save stays intact, if game crashes midway
+    const std::string tmp = slot + ".tmp";
+    try {
+      {
+      Tempest::WFile f(tmp);
+      Serialize::writeSnapshot(f,*snap);
+      }
+      std::filesystem::rename(TextCodec::toUtf16(tmp),TextCodec::toUtf16(slot));
+      }
+    catch(const std::exception& e) {
+      Tempest::Log::e("saving error: ", e.what());
+      std::error_code ec;
+      std::filesystem::remove(TextCodec::toUtf16(tmp),ec);
+      }
+    });
+  return true;
+  }
+
+void Gothic::waitSave() {
+  if(saveTh.joinable())
+    saveTh.join();
+  }
+
 void Gothic::startLoad(std::string_view banner,
                        const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
   implStartLoadSave(banner,true,f);
@@ -473,6 +524,9 @@ void Gothic::implStartLoadSave(std::string_view banner,
   loadTex = banner.empty() ? &saveTex : Resources::loadTexture(banner);
   loadProgress.store(0);
 
+  // savegame may still be in flight
+  waitSave();
+
   auto zero=LoadState::Idle;
   auto one =load ? LoadState::Loading : LoadState::Saving;
   if(!loadingFlag.compare_exchange_strong(zero,one)){
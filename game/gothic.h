@@ -124,12 +124,28 @@ class Gothic final {
     bool         doClock() const { return showTime; }
     void         setClock(bool t) { showTime = t; }
 
+    bool         isParallelNpcTick() const { return parallelNpcTick; }
+    void         setParallelNpcTick(bool p) { parallelNpcTick = p; }
+
+    bool         isAnimLod() const { return animLod; }
+    void         setAnimLod(bool l) { animLod = l; }
+
+    bool         isSnapshotSave() const { return snapshotSave; }
+    void         setSnapshotSave(bool s) { snapshotSave = s; }
+
+    bool         isLightClusters() const { return lightClusters; }
+    void         setLightClusters(bool c) { lightClusters = c; }
+
+    size_t       pfxBudget() const { return pfxBudgetMax; }
+    void         setPfxBudget(size_t n) { pfxBudgetMax = n; }
+
     Tempest::Signal<void()> toggleGi;
 
     LoadState    checkLoading() const;
     bool         finishLoading();
     void         startLoad(std::string_view banner, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
     void         startSave(Tempest::Texture2d&& tex, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
+    bool         startSnapshotSave(std::string_view slot, std::string_view name, const Tempest::Pixmap& pm);
     void         cancelLoading();
 
     void         tick(uint64_t dt);
@@ -197,6 +213,11 @@ class Gothic final {
     bool                                    desktop        = false;
     bool                                    showFpsCounter = false;
     bool                                    showTime       = false;
+    bool                                    parallelNpcTick = false;
+    bool                                    animLod        = true;
+    bool                                    snapshotSave   = true;
+    bool                                    lightClusters  = false;
+    size_t                                  pfxBudgetMax   = 32*1024;
 
     std::string                             wrldDef, plDef, gameDatDef, ouDef;
 
@@ -211,6 +232,7 @@ class Gothic final {
     std::atomic_int                         loadProgress{0};
     std::thread                             loaderTh;
     std::atomic<LoadState>                  loadingFlag{LoadState::Idle};
+    std::thread                             saveTh;
 
     std::unique_ptr<GameSession>            game, pendingGame;
     std::unique_ptr<FightAi>                fight;
@@ -238,6 +260,7 @@ class Gothic final {
                                                               bool load,
                                                               const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
 
+    void                                    waitSave();
     void                                    detectGothicVersion();
     void                                    setupSettings();
 
@@ -0,0 +1,120 @@
+#include "lightclusters.h"
+
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <cmath>
+#include <bit>
+
+using namespace Tempest;
+
+LightClusters::LightClusters(uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ)
+  :szX(std::clamp(sizeX,1u,MaxTiles)), szY(std::clamp(sizeY,1u,MaxTiles)), szZ(std::max(sizeZ,1u)) {
+  if(sizeX>MaxTiles || sizeY>MaxTiles)
+    Log::e("LightClusters: ",sizeX,"x",sizeY," tiles requested, clamped to ",szX,"x",szY);
+  }
+
+LightClusters::Plane LightClusters::mkPlane(const float a[4], const float b[4], float k) {
+  Plane p;
+  p.x = a[0]-k*b[0];
+  p.y = a[1]-k*b[1];
+  p.z = a[2]-k*b[2];
+  p.w = a[3]-k*b[3];
+
+  const float l = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+  if(l>0.f) {
+    p.x /= l;
+    p.y /= l;
+    p.z /= l;
+    p.w /= l;
+    }
+  return p;
+  }
+
+void LightClusters::begin(const float m[16], float zNear, float zFar) {
+  // rows of column-major matrix; clip.x >= k*clip.w is a plane in world space
+  const float row0[4] = {m[0], m[4], m[8],  m[12]};
+  const float row1[4] = {m[1], m[5], m[9],  m[13]};
+  const float row3[4] = {m[3], m[7], m[11], m[15]};
+  const float zero[4] = {};
+
+  planeX.resize(szX+1);
+  for(uint32_t i=0; i<=szX; ++i)
+    planeX[i] = mkPlane(row0,row3,-1.f+2.f*float(i)/float(szX));
+  planeY.resize(szY+1);
+  for(uint32_t i=0; i<=szY; ++i)
+    planeY[i] = mkPlane(row1,row3,-1.f+2.f*float(i)/float(szY));
+  planeW = mkPlane(row3,zero,0);
+
+  zNear = std::max(zNear, 0.001f);
+  zFar  = std::max(zFar,  zNear*1.001f);
+  depth.resize(szZ+1);
+  for(uint32_t i=0; i<=szZ; ++i)
+    depth[i] = zNear*std::pow(zFar/zNear, float(i)/float(szZ));
+
+  light.clear();
+  }
+
+void LightClusters::add(float x, float y, float z, float range, uint32_t id) {
+  const float d = planeW.dist(x,y,z);
+  if(d+range<=depth.front() || d-range>=depth.back())
+    return;
+
+  Light l;
+  l.id    = id;
+  l.maskX = overlap(planeX,x,y,z,range);
+  l.maskY = overlap(planeY,x,y,z,range);
+  if(l.maskX==0 || l.maskY==0)
+    return;
+  // slices with depth[z] < d+range and depth[z+1] > d-range
+  l.z0    = slice(d-range);
+  l.z1    = uint32_t(std::distance(depth.begin(), std::lower_bound(depth.begin(),depth.end(),d+range)));
+  l.z1    = std::clamp(l.z1,1u,szZ)-1;
+  light.push_back(l);
+  }
+
+void LightClusters::end() {
+  grid.assign(size_t(szX)*szY*szZ, Cluster());
+
+  for(auto& l:light)
+    for(uint32_t z=l.z0; z<=l.z1; ++z)
+      for(uint32_t my=l.maskY; my!=0; my&=my-1)
+        for(uint32_t mx=l.maskX; mx!=0; mx&=mx-1)
+          grid[clusterId(uint32_t(std::countr_zero(mx)),uint32_t(std::countr_zero(my)),z)].count++;
+
+  uint32_t offset = 0;
+  for(auto& c:grid) {
+    c.offset = offset;
+    offset  += c.count;
+    c.count  = 0;
+    }
+
+  index.resize(offset);
+  for(auto& l:light)
+    for(uint32_t z=l.z0; z<=l.z1; ++z)
+      for(uint32_t my=l.maskY; my!=0; my&=my-1)
+        for(uint32_t mx=l.maskX; mx!=0; mx&=mx-1) {
+          auto& c = grid[clusterId(uint32_t(std::countr_zero(mx)),uint32_t(std::countr_zero(my)),z)];
+          index[c.offset+c.count] = l.id;
+          c.count++;
+          }
+  }
+
+uint32_t LightClusters::overlap(const std::vector<Plane>& pl, float x, float y, float z, float r) {
+  // tile i is between planes i and i+1: on positive side of first and negative side of second
+  uint32_t mask = 0;
+  float    prev = pl[0].dist(x,y,z);
+  for(size_t i=1; i<pl.size(); ++i) {
+    const float next = pl[i].dist(x,y,z);
+    if(prev>-r && next<r)
+      mask |= 1u << (i-1);
+    prev = next;
+    }
+  return mask;
+  }
+
+uint32_t LightClusters::slice(float d) const {
+  // last slice with depth[z] <= d
+  auto z = uint32_t(std::distance(depth.begin(), std::upper_bound(depth.begin(),depth.end(),d)));
+  return std::clamp(z,1u,szZ)-1;
+  }
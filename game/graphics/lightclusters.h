@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// CPU light binning into a froxel grid: sizeX*sizeY screen tiles in NDC, sizeZ exponential depth slices.
+// Cluster (x,y,z) covers ndc.x in [-1+2*x/sizeX, -1+2*(x+1)/sizeX], same for y, and depth (clip.w)
+// between slice(z) and slice(z+1). Light tests are conservative sphere-vs-plane.
+class LightClusters final {
+  public:
+    // tiles per axis are stored as 32-bit masks
+    static constexpr uint32_t MaxTiles = 32;
+
+    LightClusters(uint32_t sizeX = 16, uint32_t sizeY = 9, uint32_t sizeZ = 24);
+
+    struct Cluster final {
+      uint32_t offset = 0;
+      uint32_t count  = 0;
+      };
+
+    // viewProj is column-major, same as Tempest::Matrix4x4::data()
+    void     begin(const float viewProj[16], float zNear, float zFar);
+    void     add  (float x, float y, float z, float range, uint32_t id);
+    void     end  ();
+
+    uint32_t sizeX() const { return szX; }
+    uint32_t sizeY() const { return szY; }
+    uint32_t sizeZ() const { return szZ; }
+    size_t   clusterId(uint32_t x, uint32_t y, uint32_t z) const { return (z*szY + y)*szX + x; }
+
+    auto     clusters() const -> const std::vector<Cluster>&  { return grid;  }
+    auto     indices()  const -> const std::vector<uint32_t>& { return index; }
+    size_t   lightCount() const { return light.size(); }
+
+  private:
+    struct Plane final {
+      float x = 0, y = 0, z = 0, w = 0;
+      float dist(float px, float py, float pz) const { return x*px + y*py + z*pz + w; }
+      };
+
+    struct Light final {
+      uint32_t id    = 0;
+      uint32_t maskX = 0;
+      uint32_t maskY = 0;
+      uint32_t z0    = 0;
+      uint32_t z1    = 0;
+      };
+
+    static Plane mkPlane(const float a[4], const float b[4], float k);
+    static uint32_t overlap(const std::vector<Plane>& pl, float x, float y, float z, float r);
+    uint32_t     slice(float depth) const;
+
+    uint32_t              szX = 0, szY = 0, szZ = 0;
+    std::vector<Plane>    planeX, planeY;
+    Plane                 planeW;
+    std::vector<float>    depth;
+
+    std::vector<Light>    light;
+    std::vector<Cluster>  grid;
+    std::vector<uint32_t> index;
+  };
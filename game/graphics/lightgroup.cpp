@@ -5,31 +5,47 @@
 
 #include <zenkit/Archive.hh>
 
+#include <atomic>
+#include <cstring>
+
 #include "graphics/shaders.h"
 #include "graphics/sceneglobals.h"
 #include "utils/string_frm.h"
 #include "world/world.h"
 #include "utils/dbgpainter.h"
+#include "utils/profiler.h"
 #include "gothic.h"
 
 using namespace Tempest;
 
+static void bitSet(std::vector<uint32_t>& b, size_t id) {
+  static_assert(sizeof(std::atomic<uint32_t>)==sizeof(uint32_t));
+  auto& bits = b[id/32];
+  id %= 32;
+  reinterpret_cast<std::atomic<uint32_t>&>(bits).fetch_or(1u << id, std::memory_order_relaxed);
+  }
+
+static bool bitAt(const std::vector<uint32_t>& b, size_t id) {
+  return (b[id/32] & (1u << (id%32)))!=0;
+  }
+
 size_t LightGroup::LightBucket::alloc() {
-  for(auto& i:updated)
-    i = false;
   if(freeList.size()>0) {
     auto ret = freeList.back();
     freeList.pop_back();
+    markDurty(ret);
     return ret;
     }
   data.emplace_back();
   light.emplace_back();
+  for(auto& d:durty)
+    d.resize((data.size()+32-1)/32, 0);
+  // free+alloc at tail leaves size as is, so ssbo of some frame may not be reallocated
+  markDurty(data.size()-1);
   return data.size()-1;
   }
 
 void LightGroup::LightBucket::free(size_t id) {
-  for(auto& i:updated)
-    i = false;
   if(id+1==data.size()) {
     data.pop_back();
     light.pop_back();
@@ -37,7 +53,33 @@ void LightGroup::LightBucket::free(size_t id) {
     light[id].setRange(0);
     data[id] = LightSsbo();
     freeList.push_back(id);
+    markDurty(id);
+    }
+  }
+
+void LightGroup::LightBucket::markDurty(size_t id) {
+  for(auto& d:durty)
+    bitSet(d,id);
+  }
+
+void LightGroup::LightBucket::upload(uint8_t fId) {
+  auto&        d   = durty[fId];
+  auto&        buf = ssbo[fId];
+  const size_t cnt = data.size();
+  for(size_t i=0; i<cnt; ++i) {
+    if(i%32==0 && d[i/32]==0) {
+      i+=31;
+      continue;
+      }
+    if(!bitAt(d,i))
+      continue;
+    // coalesce adjacent lights into one write
+    const size_t begin = i;
+    while(i<cnt && bitAt(d,i))
+      ++i;
+    buf.update(data.data()+begin, begin*sizeof(LightSsbo), (i-begin)*sizeof(LightSsbo));
     }
+  std::memset(d.data(), 0, d.size()*sizeof(d[0]));
   }
 
 
@@ -291,6 +333,14 @@ void LightGroup::dbgLights(DbgPainter& p) const {
 
   string_frm name("light count = ",cnt);
   p.drawText(10,50,name);
+
+  if(Gothic::inst().isLightClusters()) {
+    uint32_t maxPerCluster = 0;
+    for(auto& c:clusters.clusters())
+      maxPerCluster = std::max(maxPerCluster,c.count);
+    string_frm cl("clustered lights = ",clusters.lightCount(),", indices = ",clusters.indices().size(),", max per cluster = ",maxPerCluster);
+    p.drawText(10,70,cl);
+    }
   }
 
 void LightGroup::free(size_t id) {
@@ -302,13 +352,11 @@ void LightGroup::free(size_t id) {
 
 LightGroup::LightSsbo& LightGroup::get(size_t id) {
   if(id & staticMask) {
-    for(auto& i:bucketSt.updated)
-      i = false;
+    bucketSt.markDurty(id^staticMask);
     return bucketSt.data[id^staticMask];
     }
 
-  for(auto& i:bucketDyn.updated)
-    i = false;
+  bucketDyn.markDurty(id);
   return bucketDyn.data[id];
   }
 
@@ -337,32 +385,35 @@ const zenkit::LightPreset& LightGroup::findPreset(std::string_view preset) const
   }
 
 void LightGroup::tick(uint64_t time) {
+  Profiler::Zone zone("LightGroup::tick");
   for(size_t i=0; i<bucketDyn.light.size(); ++i) {
     auto& light = bucketDyn.light[i];
     light.update(time);
 
+    const Vec3  pos   = light.position();
+    const Vec3  color = light.currentColor();
+    const float range = light.currentRange();
+
     auto& ssbo = bucketDyn.data[i];
-    ssbo.pos   = light.position();
-    ssbo.color = light.currentColor();
-    ssbo.range = light.currentRange();
+    if(ssbo.pos==pos && ssbo.color==color && ssbo.range==range)
+      continue;
+    ssbo.pos   = pos;
+    ssbo.color = color;
+    ssbo.range = range;
+    bucketDyn.markDurty(i);
     }
-
-  for(auto& updated:bucketDyn.updated)
-    updated = false;
   }
 
 void LightGroup::preFrameUpdate(uint8_t fId) {
   auto& device = Resources::device();
   LightBucket* bucket[2] = {&bucketSt, &bucketDyn};
   for(auto b:bucket) {
-    if(b->updated[fId])
-      continue;
-    b->updated[fId] = true;
     if(b->ssbo[fId].byteSize()==b->data.size()*sizeof(b->data[0])) {
-      b->ssbo[fId].update(b->data);
+      b->upload(fId);
       } else {
       b->ssbo[fId] = device.ssbo(BufferHeap::Upload,b->data);
       b->ubo [fId].set(4,b->ssbo[fId]);
+      std::memset(b->durty[fId].data(), 0, b->durty[fId].size()*sizeof(uint32_t));
       }
     }
 
@@ -376,6 +427,25 @@ void LightGroup::preFrameUpdate(uint8_t fId) {
   std::memcpy(ubo.fr,fr.f,sizeof(ubo.fr));
 
   uboBuf[fId].update(&ubo);
+
+  if(Gothic::inst().isLightClusters())
+    buildClusters();
+  }
+
+void LightGroup::buildClusters() {
+  Profiler::Zone zone("LightGroup::buildClusters");
+  clusters.begin(scene.viewProject().data(), scene.znear, scene.clipInfo().z);
+  for(size_t i=0; i<bucketSt.data.size(); ++i) {
+    auto& l = bucketSt.data[i];
+    if(l.range>0)
+      clusters.add(l.pos.x,l.pos.y,l.pos.z,l.range,uint32_t(i) | ClusterStaticBit);
+    }
+  for(size_t i=0; i<bucketDyn.data.size(); ++i) {
+    auto& l = bucketDyn.data[i];
+    if(l.range>0)
+      clusters.add(l.pos.x,l.pos.y,l.pos.z,l.range,uint32_t(i));
+    }
+  clusters.end();
   }
 
 void LightGroup::draw(Encoder<CommandBuffer>& cmd, uint8_t fId) {
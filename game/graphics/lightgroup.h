@@ -3,6 +3,7 @@
 #include <Tempest/CommandBuffer>
 #include <zenkit/vobs/Light.hh>
 
+#include "lightclusters.h"
 #include "lightsource.h"
 #include "resources.h"
 
@@ -56,6 +57,10 @@ class LightGroup final {
 
     void   draw(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId);
 
+    // light-index lists per froxel; ids of static lights have ClusterStaticBit set
+    static constexpr uint32_t ClusterStaticBit = 0x80000000u;
+    auto   lightClusters() const -> const LightClusters& { return clusters; }
+
   private:
     using Vertex = Resources::VertexL;
 
@@ -83,13 +88,15 @@ class LightGroup final {
       std::vector<LightSource> light;
       std::vector<LightSsbo>   data;
       Tempest::StorageBuffer   ssbo[Resources::MaxFramesInFlight];
-      bool                     updated[Resources::MaxFramesInFlight] = {};
+      std::vector<uint32_t>    durty[Resources::MaxFramesInFlight];
 
       std::vector<size_t>      freeList;
       Tempest::DescriptorSet   ubo[Resources::MaxFramesInFlight];
 
       size_t                   alloc();
       void                     free(size_t id);
+      void                     markDurty(size_t id);
+      void                     upload(uint8_t fId);
       };
 
     size_t                     alloc(bool dynamic);
@@ -99,6 +106,7 @@ class LightGroup final {
     LightSource&               getL(size_t id);
 
     Tempest::RenderPipeline&   shader() const;
+    void                       buildClusters();
 
     const zenkit::LightPreset& findPreset(std::string_view preset) const;
 
@@ -111,5 +119,6 @@ class LightGroup final {
 
     std::recursive_mutex                 sync;
     LightBucket                          bucketSt, bucketDyn;
+    LightClusters                        clusters;
   };
 
@@ -11,7 +11,7 @@ static Tempest::Color toColor(glm::u8vec4 v) {
   }
 
 Material::Material(const zenkit::Material& m, bool enableAlphaTest) {
-  tex = Resources::loadTexture(m.texture);
+  tex = Resources::loadTextureAsync(m.texture);
   if(tex==nullptr) {
     if(!m.texture.empty()) {
       tex = Resources::loadTexture("DEFAULT.TGA");
@@ -45,7 +45,7 @@ Material::Material(const zenkit::Material& m, bool enableAlphaTest) {
   }
 
 Material::Material(const zenkit::VisualDecal& decal) {
-  tex = Resources::loadTexture(decal.name);
+  tex = Resources::loadTextureAsync(decal.name);
   if(tex==nullptr && !decal.name.empty())
     tex = Resources::loadTexture("DEFAULT.TGA");
   loadFrames(decal.name, decal.texture_anim_fps);
@@ -55,7 +55,7 @@ Material::Material(const zenkit::VisualDecal& decal) {
   }
 
 Material::Material(const zenkit::IParticleEffect& src) {
-  tex = Resources::loadTexture(src.vis_name_s);
+  tex = Resources::loadTextureAsync(src.vis_name_s);
   loadFrames(src.vis_name_s, src.vis_tex_ani_fps);
 
   //TODO: visTexAniIsLooping
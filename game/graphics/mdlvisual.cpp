@@ -831,24 +831,36 @@ void MdlVisual::rebindAttaches(Attach<View>& mesh, const Skeleton& to) {
   }
 
 void MdlVisual::syncAttaches() {
+  auto& pose = *skInst;
+  syncAttaches(pos,pose.transform(),pose.boneCount());
+  }
+
+void MdlVisual::setRenderPose(const Tempest::Matrix4x4* tr, size_t count) {
+  // interpolated state from RenderSnapshot: tr[0] is object matrix, followed by bones of this skeleton
+  if(count!=skInst->boneCount()+1)
+    return;
+  view.setPose(tr[0],tr+1);
+  syncAttaches(tr[0],tr+1,count-1);
+  }
+
+void MdlVisual::syncAttaches(const Tempest::Matrix4x4& obj, const Tempest::Matrix4x4* tr, size_t count) {
   MdlVisual::MeshAttach* mesh[] = {&head, &sword,&shield,&bow,&ammunition,&stateItm};
   for(auto i:mesh)
-    syncAttaches(*i);
+    syncAttaches(*i,obj,tr,count);
   for(auto& i:item)
-    syncAttaches(i);
+    syncAttaches(i,obj,tr,count);
   for(auto& i:attach)
-    syncAttaches(i);
+    syncAttaches(i,obj,tr,count);
   for(auto& i:effects) {
-    i.view.setObjMatrix(pos);
+    i.view.setObjMatrix(obj);
     // i.view.setTarget(targetPos);
     }
-  pfx.view.setObjMatrix(pos);
-  hnpcVisual.view.setObjMatrix(pos);
+  pfx.view.setObjMatrix(obj);
+  hnpcVisual.view.setObjMatrix(obj);
   if(torch.view!=nullptr) {
-    auto& pose = *skInst;
-    auto  p    = pos;
-    if(torch.boneId<pose.boneCount())
-      p = pose.bone(torch.boneId);
+    auto p = obj;
+    if(torch.boneId<count)
+      p = tr[torch.boneId];
     torch.view->setObjMatrix(p);
     }
   }
@@ -867,12 +879,17 @@ std::string_view MdlVisual::visualSkeletonScheme() const {
 
 template<class View>
 void MdlVisual::syncAttaches(Attach<View>& att) {
+  auto& pose = *skInst;
+  syncAttaches(att,pos,pose.transform(),pose.boneCount());
+  }
+
+template<class View>
+void MdlVisual::syncAttaches(Attach<View>& att, const Tempest::Matrix4x4& obj, const Tempest::Matrix4x4* tr, size_t count) {
   if(att.view.isEmpty())
     return;
-  auto& pose = *skInst;
-  auto  p    = pos;
-  if(att.boneId<pose.boneCount())
-    p = pose.bone(att.boneId);
+  auto p = obj;
+  if(att.boneId<count)
+    p = tr[att.boneId];
   att.view.setObjMatrix(p);
   }
 
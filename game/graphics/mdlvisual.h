@@ -36,6 +36,7 @@ class MdlVisual final {
     void                           setVisualBody(World& owner, MeshObjects::Mesh&& body);
     void                           setVisualBody(Npc& npc, MeshObjects::Mesh&& h, MeshObjects::Mesh&& body, int32_t version);
     void                           syncAttaches();
+    void                           setRenderPose(const Tempest::Matrix4x4* tr, size_t count);
     const Skeleton*                visualSkeleton() const;
     std::string_view               visualSkeletonScheme() const;
 
@@ -144,6 +145,9 @@ class MdlVisual final {
     void bind(Attach<View>& slot, std::string_view bone);
     template<class View>
     void syncAttaches(Attach<View>& mesh);
+    template<class View>
+    void syncAttaches(Attach<View>& mesh, const Tempest::Matrix4x4& obj, const Tempest::Matrix4x4* tr, size_t count);
+    void syncAttaches(const Tempest::Matrix4x4& obj, const Tempest::Matrix4x4* tr, size_t count);
 
     template<class View>
     void rebindAttaches(Attach<View>& mesh, const Skeleton& to);
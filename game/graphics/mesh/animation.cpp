@@ -7,6 +7,7 @@
 #include "world/objects/npc.h"
 #include "world/world.h"
 #include "resources.h"
+#include "animmath.h"
 
 using namespace Tempest;
 
@@ -193,10 +194,6 @@ Animation::Sequence::Sequence(const zenkit::MdsAnimation& hdr, std::string_view
   if(entry==nullptr)
     return;
 
-  auto reader = entry->open_read();
-  zenkit::ModelAnimation p;
-  p.load(reader.get());
-
   data = std::make_shared<AnimData>();
   askName    = hdr.name;
   layer      = hdr.layer;
@@ -209,17 +206,69 @@ Animation::Sequence::Sequence(const zenkit::MdsAnimation& hdr, std::string_view
   data->firstFrame = uint32_t(hdr.first_frame);
   data->lastFrame  = uint32_t(hdr.last_frame);
 
-
-  name = p.name;
-  layer = p.layer;
-  data->fpsRate = p.fps;
-  data->numFrames = p.frame_count;
-  data->nodeIndex = p.node_indices;
-  data->samples = p.samples;
+  if(!loadCache(fname)) {
+    auto reader = entry->open_read();
+    zenkit::ModelAnimation p;
+    p.load(reader.get());
+
+    name = p.name;
+    layer = p.layer;
+    data->fpsRate = p.fps;
+    data->numFrames = p.frame_count;
+    data->nodeIndex = p.node_indices;
+    data->setupSamples(p.samples);
+    saveCache(fname);
+    }
 
   setupMoveTr();
   }
 
+bool Animation::Sequence::loadCache(std::string_view fname) {
+  AssetCache::Reader rd;
+  if(!Resources::assetCache().load(AssetCache::K_Animation,fname,rd))
+    return false;
+
+  std::string n;
+  uint32_t    l = 0;
+  AnimData    d;
+  rd.read(n);
+  rd.read(l);
+  rd.read(d.fpsRate);
+  rd.read(d.numFrames);
+  rd.read(d.nodeIndex);
+  rd.read(d.sampleStride);
+  rd.read(d.samples);
+  if(!rd.isOk() || rd.remain()!=0)
+    return false;
+  if(d.sampleStride%4!=0 || d.sampleStride>Resources::MAX_NUM_SKELETAL_NODES ||
+     d.samples.size()%(size_t(SamplePlanes)*std::max(d.sampleStride,1u))!=0)
+    return false;
+
+  name                = std::move(n);
+  layer               = l;
+  data->fpsRate       = d.fpsRate;
+  data->numFrames     = d.numFrames;
+  data->nodeIndex     = std::move(d.nodeIndex);
+  data->sampleStride  = d.sampleStride;
+  data->samples       = std::move(d.samples);
+  data->setupSampleMask();
+  return true;
+  }
+
+void Animation::Sequence::saveCache(std::string_view fname) const {
+  if(!Resources::assetCache().isEnabled())
+    return;
+  AssetCache::Writer wr;
+  wr.write(name);
+  wr.write(uint32_t(layer));
+  wr.write(data->fpsRate);
+  wr.write(data->numFrames);
+  wr.write(data->nodeIndex);
+  wr.write(data->sampleStride);
+  wr.write(data->samples);
+  Resources::assetCache().save(AssetCache::K_Animation,fname,wr);
+  }
+
 bool Animation::Sequence::isFinished(uint64_t now, uint64_t sTime, uint16_t comboLen) const {
   const uint64_t t = now-sTime;
   if(comboLen<data->defHitEnd.size()) {
@@ -542,28 +591,28 @@ void Animation::Sequence::setupMoveTr() {
   }
 
 void Animation::AnimData::setupMoveTr() {
-  size_t sz = nodeIndex.size();
-  if(sz==0)
+  const size_t sz     = nodeIndex.size();
+  const size_t frame  = SamplePlanes*sampleStride;
+  const size_t frames = frame>0 ? samples.size()/frame : 0;
+  if(sz==0 || frames==0)
     return;
 
+  auto rootPos = [this,frame](size_t f) {
+    const float* smp = &samples[f*frame];
+    return Tempest::Vec3(smp[0],smp[sampleStride],smp[2*sampleStride]);
+    };
+
   if(nodeIndex[0]!=0)
     return;
 
-  if(0<samples.size() && sz<=samples.size()) {
-    auto& a = samples[0].position;
-    auto& b = samples[samples.size()-sz].position;
-    moveTr.x = b.x-a.x;
-    moveTr.y = b.y-a.y;
-    moveTr.z = b.z-a.z;
-
-    tr.resize(samples.size()/sz - 1);
-    for(size_t i=0, r=0; r<tr.size(); i+=sz,++r) {
-      auto& p  = tr[r];
-      auto& bi = samples[i].position;
-      p.x = bi.x-a.x;
-      p.y = bi.y-a.y;
-      p.z = bi.z-a.z;
-      }
+  {
+    const auto a = rootPos(0);
+    const auto b = rootPos(frames-1);
+    moveTr = b-a;
+
+    tr.resize(frames-1);
+    for(size_t r=0; r<tr.size(); ++r)
+      tr[r] = rootPos(r)-a;
     static const float eps = 0.4f;
     for(auto& i:tr) {
       if(std::fabs(i.x)<eps && std::fabs(i.y)<eps && std::fabs(i.z)<eps)
@@ -571,13 +620,52 @@ void Animation::AnimData::setupMoveTr() {
       hasMoveTr = true;
       break;
       }
-    }
+  }
+
+  translate = rootPos(0);
+  }
 
-  if(0<samples.size()){
-    translate.x = samples[0].position.x;
-    translate.y = samples[0].position.y;
-    translate.z = samples[0].position.z;
+void Animation::AnimData::setupSamples(const std::vector<zenkit::AnimationSample>& smp) {
+  const size_t sz = nodeIndex.size();
+  samples.clear();
+  sampleStride = 0;
+  if(sz==0)
+    return;
+
+  size_t lanes = 0;
+  for(auto id:nodeIndex)
+    if(id<Resources::MAX_NUM_SKELETAL_NODES)
+      lanes = std::max<size_t>(lanes,id+1);
+
+  const size_t frames = smp.size()/sz;
+  sampleStride = uint32_t((lanes+3) & ~size_t(3));
+  samples.resize(frames*SamplePlanes*sampleStride, 0.f);
+  for(size_t f=0; f<frames; ++f) {
+    float* dst = &samples[f*SamplePlanes*sampleStride];
+    // nodes, that are not animated: identity rotation
+    std::fill(dst+6*sampleStride, dst+7*sampleStride, 1.f);
+    for(size_t i=0; i<sz; ++i) {
+      const size_t id = nodeIndex[i];
+      if(id>=sampleStride)
+        continue;
+      auto& s = smp[f*sz+i];
+      dst[0*sampleStride+id] = s.position.x;
+      dst[1*sampleStride+id] = s.position.y;
+      dst[2*sampleStride+id] = s.position.z;
+      dst[3*sampleStride+id] = s.rotation.x;
+      dst[4*sampleStride+id] = s.rotation.y;
+      dst[5*sampleStride+id] = s.rotation.z;
+      dst[6*sampleStride+id] = s.rotation.w;
+      }
     }
+  setupSampleMask();
+  }
+
+void Animation::AnimData::setupSampleMask() {
+  sampleMask.assign(sampleStride,0);
+  for(auto id:nodeIndex)
+    if(id<sampleStride)
+      sampleMask[id] = 1;
   }
 
 void Animation::AnimData::setupEvents(float fpsRate) {
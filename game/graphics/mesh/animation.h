@@ -42,7 +42,9 @@ class Animation final {
       Tempest::Vec3                               translate={};
       Tempest::Vec3                               moveTr={};
 
-      std::vector<zenkit::AnimationSample>        samples;
+      std::vector<float>                          samples;      // SoA: frames x SamplePlanes x sampleStride, lane is a node id
+      uint32_t                                    sampleStride=0;
+      std::vector<uint8_t>                        sampleMask;   // lanes present in nodeIndex
       std::vector<uint32_t>                       nodeIndex;
       std::vector<Tempest::Vec3>                  tr;
       bool                                        hasMoveTr=false;
@@ -67,6 +69,8 @@ class Animation final {
 
       void                                        setupMoveTr();
       void                                        setupEvents(float fpsRate);
+      void                                        setupSamples(const std::vector<zenkit::AnimationSample>& smp);
+      void                                        setupSampleMask();
       };
 
     struct Sequence final {
@@ -113,6 +117,8 @@ class Animation final {
 
       private:
         void                                 setupMoveTr();
+        bool                                 loadCache(std::string_view fname);
+        void                                 saveCache(std::string_view fname) const;
         static void                          processEvent(const zenkit::MdsEventTag& e, EvCount& ev, uint64_t time);
         bool                                 extractFrames(uint64_t &frameA, uint64_t &frameB, bool &invert, uint64_t barrier, uint64_t sTime, uint64_t now) const;
       };
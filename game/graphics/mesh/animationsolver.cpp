@@ -9,6 +9,10 @@
 #include "pose.h"
 #include "resources.h"
 
+#include <mutex>
+#include <map>
+#include <iterator>
+
 using namespace Tempest;
 
 AnimationSolver::AnimationSolver() {
@@ -100,265 +104,394 @@ void AnimationSolver::update(uint64_t tickCount) {
     }
   }
 
+namespace {
+enum Frm : uint8_t {
+  T_FISTATTACKMOVE, S_FISTATTACK, T_FISTPARADE_0, T_FISTPARADE_O,
+  T_xATTACKMOVE, T_xATTACKL, T_xATTACKR, S_xATTACK,
+  T_xPARADE_0, T_xPARADE_0_A2, T_xPARADE_0_A3, T_xPARADE_O, T_xSFINISH,
+  T_xRELOAD, S_xAIM, S_xRUN, S_xSHOOT,
+  T_CASTFAIL,
+  S_DIVE, S_SWIM, S_xSNEAK, S_xWALK,
+  S_DIVEF, S_SWIMF, S_xSNEAKL, S_xWALKL, S_xWALKWL, S_xRUNL,
+  T_xSNEAKSTRAFEL, T_xWALKWSTRAFEL, T_xRUNSTRAFEL,
+  T_xSNEAKSTRAFER, T_xWALKWSTRAFER, T_xRUNSTRAFER,
+  S_SWIMB, S_xSNEAKBL, T_xPARADEJUMPB, T_xJUMPB,
+  T_DIVETURNL, T_SWIMTURNL, T_SNEAKTURNL, T_xWALKTURNL, T_xWALKWTURNL, T_xRUNTURNL,
+  T_DIVETURNR, T_SWIMTURNR, T_SNEAKTURNR, T_xWALKTURNR, T_xWALKWTURNR, T_xRUNTURNR,
+  S_JUMP, S_JUMPUPLOW, S_JUMPUPMID, S_JUMPUP, T_JUMPUP_2_HANG, T_HANG_2_STAND,
+  S_FALLDN, S_FALLEN, S_FALLENB, S_FALL, S_FALLB, S_SLIDE, S_SLIDEB, T_STUMBLE, T_STUMBLEB,
+  T_WOUNDED_2_DEAD, T_WOUNDEDB_2_DEADB, T_DEAD, T_DEADB, S_DEAD, S_DEADB,
+  T_STAND_2_WOUNDED, T_STAND_2_WOUNDEDB, S_IGET, S_IDROP, T_POINT,
+  T_xMOVE_2_MOVE, T_xRUN_2_x, T_MOVE_2_xMOVE, T_x_2_xRUN,
+  FrmCount
+  };
+
+// '%s' is substituted by weapon name
+const char* const frmName[] = {
+  "T_FISTATTACKMOVE", "S_FISTATTACK", "T_FISTPARADE_0", "T_FISTPARADE_O",
+  "T_%sATTACKMOVE", "T_%sATTACKL", "T_%sATTACKR", "S_%sATTACK",
+  "T_%sPARADE_0", "T_%sPARADE_0_A2", "T_%sPARADE_0_A3", "T_%sPARADE_O", "T_%sSFINISH",
+  "T_%sRELOAD", "S_%sAIM", "S_%sRUN", "S_%sSHOOT",
+  "T_CASTFAIL",
+  "S_DIVE", "S_SWIM", "S_%sSNEAK", "S_%sWALK",
+  "S_DIVEF", "S_SWIMF", "S_%sSNEAKL", "S_%sWALKL", "S_%sWALKWL", "S_%sRUNL",
+  "T_%sSNEAKSTRAFEL", "T_%sWALKWSTRAFEL", "T_%sRUNSTRAFEL",
+  "T_%sSNEAKSTRAFER", "T_%sWALKWSTRAFER", "T_%sRUNSTRAFER",
+  "S_SWIMB", "S_%sSNEAKBL", "T_%sPARADEJUMPB", "T_%sJUMPB",
+  "T_DIVETURNL", "T_SWIMTURNL", "T_SNEAKTURNL", "T_%sWALKTURNL", "T_%sWALKWTURNL", "T_%sRUNTURNL",
+  "T_DIVETURNR", "T_SWIMTURNR", "T_SNEAKTURNR", "T_%sWALKTURNR", "T_%sWALKWTURNR", "T_%sRUNTURNR",
+  "S_JUMP", "S_JUMPUPLOW", "S_JUMPUPMID", "S_JUMPUP", "T_JUMPUP_2_HANG", "T_HANG_2_STAND",
+  "S_FALLDN", "S_FALLEN", "S_FALLENB", "S_FALL", "S_FALLB", "S_SLIDE", "S_SLIDEB", "T_STUMBLE", "T_STUMBLEB",
+  "T_WOUNDED_2_DEAD", "T_WOUNDEDB_2_DEADB", "T_DEAD", "T_DEADB", "S_DEAD", "S_DEADB",
+  "T_STAND_2_WOUNDED", "T_STAND_2_WOUNDEDB", "S_IGET", "S_IDROP", "T_POINT",
+  "T_%sMOVE_2_MOVE", "T_%sRUN_2_%s", "T_MOVE_2_%sMOVE", "T_%s_2_%sRUN",
+  };
+static_assert(std::size(frmName)==FrmCount);
+
+// sets of sequences, that pose-dependent selection tests with isInAnim
+enum InAnim : uint8_t {
+  In_FISTRUNL, In_FALL, In_FALLB, In_WOUNDED,
+  InAnimCount
+  };
+
+const char* const inAnimName[][4] = {
+  {"S_FISTRUNL"},
+  {"S_FALL",  "S_FALLEN"},
+  {"S_FALLB", "S_FALLENB"},
+  {"S_WOUNDED", "T_STAND_2_WOUNDED", "S_WOUNDEDB", "T_STAND_2_WOUNDEDB"},
+  };
+static_assert(std::size(inAnimName)==InAnimCount);
+
+enum : uint8_t {
+  WeaponCount = uint8_t(WeaponState::Mage)+1,
+  WalkCount   = 6,
+  AnimCount   = AnimationSolver::MagNoMana+1,
+  };
+
+// representative walk-mode for each walkClass
+const WalkBit walkClassBit[WalkCount] = {
+  WalkBit::WM_Run, WalkBit::WM_Water, WalkBit::WM_Walk, WalkBit::WM_Sneak, WalkBit::WM_Swim, WalkBit::WM_Dive
+  };
+}
+
+struct AnimationSolver::Mag final {
+  // indexed by run*2 + invest
+  const Animation::Sequence*      sq[4] = {};
+  };
+
+struct AnimationSolver::Bind final {
+  const Skeleton*                 baseSk = nullptr;
+  std::vector<const Skeleton*>    overlay;
+
+  const Animation::Sequence*      frm [FrmCount][WeaponCount] = {};
+  const Animation::Sequence*      anim[AnimCount][WeaponCount][WalkCount] = {};
+  // every sequence with a matching name in base skeleton or overlays: pose may play any of them
+  std::vector<const Animation::Sequence*> inAnim[InAnimCount];
+
+  // spell animations by scheme, resolved on first cast
+  mutable std::mutex                            magSync;
+  mutable std::map<std::string,Mag,std::less<>> mag;
+
+  bool isInAnim(const Pose& pose, InAnim a) const {
+    for(auto sq:inAnim[a])
+      if(pose.isInAnim(sq))
+        return true;
+    return false;
+    }
+  };
+
 const Animation::Sequence* AnimationSolver::solveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
-  if(0<a && a<=AnimationSolver::CacheLast && int(st)<2 && int(wlkMode)<2) {
-    auto& ptr = cache[a-1][int(st)][int(wlkMode)];
-    if(ptr==nullptr)
-      ptr = implSolveAnim(a,st,wlkMode,pose);
-    return ptr;
+  if(a>=AnimCount)
+    return nullptr;
+  auto& b = binding();
+  if(!isPoseDependent(a,wlkMode))
+    return b.anim[a][int(st)][walkClass(wlkMode)];
+  return implSolveAnim(b,a,st,wlkMode,&pose);
+  }
+
+bool AnimationSolver::isPoseDependent(Anim a, WalkBit wlk) {
+  switch(a) {
+    case Attack:
+    case AttackBlock:
+    case AimBow:
+    case JumpHang:
+    case Fallen:
+    case FallDeep:
+    case DeadA:
+    case DeadB:
+      return true;
+    case Move:
+      return bool(wlk & WalkBit::WM_Dive);
+    default:
+      return false;
     }
-  return implSolveAnim(a,st,wlkMode,pose);
   }
 
-const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
+uint8_t AnimationSolver::walkClass(WalkBit wlk) {
+  // same priority, as in implSolveAnim
+  if(bool(wlk & WalkBit::WM_Dive))
+    return 5;
+  if(bool(wlk & WalkBit::WM_Swim))
+    return 4;
+  if(bool(wlk & WalkBit::WM_Sneak))
+    return 3;
+  if(bool(wlk & WalkBit::WM_Walk))
+    return 2;
+  if(bool(wlk & WalkBit::WM_Water))
+    return 1;
+  return 0;
+  }
+
+const Animation::Sequence* AnimationSolver::implSolveAnim(const Bind& b, Anim a, WeaponState st, WalkBit wlkMode, const Pose* pose) {
+  auto solveFrm  = [&](Frm f) { return b.frm[f][int(st)]; };
+  auto solveDead = [&](Frm f1, Frm f2) { return solveFrm(f1)!=nullptr ? solveFrm(f1) : solveFrm(f2); };
+
   // Attack
   if(st==WeaponState::Fist) {
     if(a==Anim::Attack) {
-      if(pose.isInAnim("S_FISTRUNL"))
-        return solveFrm("T_FISTATTACKMOVE");
-      return solveFrm("S_FISTATTACK");
+      if(b.isInAnim(*pose,In_FISTRUNL))
+        return solveFrm(T_FISTATTACKMOVE);
+      return solveFrm(S_FISTATTACK);
       }
     if(a==Anim::AttackBlock) {
       bool g2 = Gothic::inst().version().game==2;
-      return g2 ? solveFrm("T_FISTPARADE_0") : solveFrm("T_FISTPARADE_O");
+      return g2 ? solveFrm(T_FISTPARADE_0) : solveFrm(T_FISTPARADE_O);
       }
     }
   else if(st==WeaponState::W1H || st==WeaponState::W2H) {
-    if(a==Anim::Attack && pose.hasState(BS_RUN))
-      return solveFrm("T_%sATTACKMOVE",st);
+    if(a==Anim::Attack && pose->hasState(BS_RUN))
+      return solveFrm(T_xATTACKMOVE);
     if(a==Anim::AttackL)
-      return solveFrm("T_%sATTACKL",st);
+      return solveFrm(T_xATTACKL);
     if(a==Anim::AttackR)
-      return solveFrm("T_%sATTACKR",st);
+      return solveFrm(T_xATTACKR);
     if(a==Anim::Attack || a==Anim::AttackL || a==Anim::AttackR)
-      return solveFrm("S_%sATTACK",st);
+      return solveFrm(S_xATTACK);
     if(a==Anim::AttackBlock) {
       bool g2 = Gothic::inst().version().game==2;
       if(g2) {
         const Animation::Sequence* s=nullptr;
         switch(std::rand()%3) {
-          case 0: s = solveFrm("T_%sPARADE_0",   st); break;
-          case 1: s = solveFrm("T_%sPARADE_0_A2",st); break;
-          case 2: s = solveFrm("T_%sPARADE_0_A3",st); break;
+          case 0: s = solveFrm(T_xPARADE_0); break;
+          case 1: s = solveFrm(T_xPARADE_0_A2); break;
+          case 2: s = solveFrm(T_xPARADE_0_A3); break;
           }
         if(s==nullptr)
-          s = solveFrm("T_%sPARADE_0",st);
+          s = solveFrm(T_xPARADE_0);
         return s;
         } else {
-        return solveFrm("T_%sPARADE_O",st);
+        return solveFrm(T_xPARADE_O);
         }
       }
     if(a==Anim::AttackFinish)
-      return solveFrm("T_%sSFINISH",st);
+      return solveFrm(T_xSFINISH);
     }
   else if(st==WeaponState::Bow || st==WeaponState::CBow) {
     // S_BOWAIM -> S_BOWSHOOT+T_BOWRELOAD -> S_BOWAIM
     if(a==AimBow) {
-      auto bs = pose.bodyState();
+      auto bs = pose->bodyState();
       if(bs==BS_HIT)
-        return solveFrm("T_%sRELOAD",st);
-      if(bs==BS_AIMNEAR || bs==BS_AIMFAR || pose.isStanding())
-        return solveFrm("S_%sAIM",st);
-      return solveFrm("S_%sRUN",st);
+        return solveFrm(T_xRELOAD);
+      if(bs==BS_AIMNEAR || bs==BS_AIMFAR || pose->isStanding())
+        return solveFrm(S_xAIM);
+      return solveFrm(S_xRUN);
       }
     if(a==Attack) {
-      auto bs = pose.bodyState();
+      auto bs = pose->bodyState();
       if(bs==BS_AIMNEAR || bs==BS_AIMFAR)
-        return solveFrm("S_%sSHOOT",st);
+        return solveFrm(S_xSHOOT);
       }
     }
 
   if(a==MagNoMana)
-    return solveFrm("T_CASTFAIL");
+    return solveFrm(T_CASTFAIL);
   // Move
   if(a==Idle) {
     const Animation::Sequence* s = nullptr;
     if(bool(wlkMode & WalkBit::WM_Dive))
-      s = solveFrm("S_DIVE");
+      s = solveFrm(S_DIVE);
     else if(bool(wlkMode & WalkBit::WM_Swim))
-      s = solveFrm("S_SWIM");
+      s = solveFrm(S_SWIM);
     else if(bool(wlkMode&WalkBit::WM_Sneak))
-      s = solveFrm("S_%sSNEAK",st);
+      s = solveFrm(S_xSNEAK);
     else if(bool(wlkMode&WalkBit::WM_Walk))
-      s = solveFrm("S_%sWALK",st);
+      s = solveFrm(S_xWALK);
     else
-      s = solveFrm("S_%sRUN",st);
+      s = solveFrm(S_xRUN);
 
     if(s==nullptr) {
       // make sure that 'Idle' has something at least
-      s = solveFrm("S_%sWALK",st);
+      s = solveFrm(S_xWALK);
       }
     return s;
     }
   if(a==Move)  {
     if(bool(wlkMode & WalkBit::WM_Dive)) {
-      if(pose.bodyState()==BS_DIVE)
-        return solveFrm("S_DIVEF",st); else
-        return solveFrm("S_DIVE");
+      if(pose->bodyState()==BS_DIVE)
+        return solveFrm(S_DIVEF); else
+        return solveFrm(S_DIVE);
       }
     const Animation::Sequence* s = nullptr;
     if(bool(wlkMode & WalkBit::WM_Swim))
-      s = solveFrm("S_SWIMF",st);
+      s = solveFrm(S_SWIMF);
     else if(bool(wlkMode & WalkBit::WM_Sneak))
-      s = solveFrm("S_%sSNEAKL",st);
+      s = solveFrm(S_xSNEAKL);
     else if(bool(wlkMode & WalkBit::WM_Walk))
-      s = solveFrm("S_%sWALKL",st);
+      s = solveFrm(S_xWALKL);
     else if(bool(wlkMode & WalkBit::WM_Water))
-      s = solveFrm("S_%sWALKWL",st);
+      s = solveFrm(S_xWALKWL);
     if(s!=nullptr)
       return s;
-    return solveFrm("S_%sRUNL",st);
+    return solveFrm(S_xRUNL);
     }
   if(a==MoveL) {
     if(bool(wlkMode & WalkBit::WM_Dive))
-      return solveFrm("S_DIVE"); // ???
+      return solveFrm(S_DIVE); // ???
     if(bool(wlkMode & WalkBit::WM_Swim))
-      return solveFrm("S_SWIM"); // ???
+      return solveFrm(S_SWIM); // ???
     if(bool(wlkMode & WalkBit::WM_Sneak))
-      return solveFrm("T_%sSNEAKSTRAFEL",st);
+      return solveFrm(T_xSNEAKSTRAFEL);
     if(bool(wlkMode & WalkBit::WM_Walk))
-      return solveFrm("T_%sWALKWSTRAFEL",st);
+      return solveFrm(T_xWALKWSTRAFEL);
     if(bool(wlkMode & WalkBit::WM_Water))
-      return solveFrm("T_%sWALKWSTRAFEL",st);
-    return solveFrm("T_%sRUNSTRAFEL",st);
+      return solveFrm(T_xWALKWSTRAFEL);
+    return solveFrm(T_xRUNSTRAFEL);
     }
   if(a==MoveR) {
     if(bool(wlkMode & WalkBit::WM_Dive))
-      return solveFrm("S_DIVE"); // ???
+      return solveFrm(S_DIVE); // ???
     if(bool(wlkMode & WalkBit::WM_Swim))
-      return solveFrm("S_SWIM"); // ???
+      return solveFrm(S_SWIM); // ???
     if(bool(wlkMode & WalkBit::WM_Sneak))
-      return solveFrm("T_%sSNEAKSTRAFER",st);
+      return solveFrm(T_xSNEAKSTRAFER);
     if(bool(wlkMode & WalkBit::WM_Walk))
-      return solveFrm("T_%sWALKWSTRAFER",st);
+      return solveFrm(T_xWALKWSTRAFER);
     if(bool(wlkMode & WalkBit::WM_Water))
-      return solveFrm("T_%sWALKWSTRAFER",st);
-    return solveFrm("T_%sRUNSTRAFER",st);
+      return solveFrm(T_xWALKWSTRAFER);
+    return solveFrm(T_xRUNSTRAFER);
     }
   if(a==MoveBack) {
     const Animation::Sequence* s = nullptr;
     if(bool(wlkMode & WalkBit::WM_Dive))
-      s = solveFrm("S_DIVE");
+      s = solveFrm(S_DIVE);
     else if(bool(wlkMode & WalkBit::WM_Swim))
-      s = solveFrm("S_SWIMB");
+      s = solveFrm(S_SWIMB);
     else if(bool(wlkMode & WalkBit::WM_Sneak))
-      s = solveFrm("S_%sSNEAKBL",st);
+      s = solveFrm(S_xSNEAKBL);
     else if(st==WeaponState::Fist)
-      s = solveFrm("T_%sPARADEJUMPB",st);
+      s = solveFrm(T_xPARADEJUMPB);
     if(s!=nullptr)
       return s;
     // This is bases on original game: if no move-back animation, even in water, game defaults to standard walk-back
-    return solveFrm("T_%sJUMPB",st);
+    return solveFrm(T_xJUMPB);
     }
   // Rotation
   if(a==RotL) {
     if(bool(wlkMode & WalkBit::WM_Dive))
-      return solveFrm("T_DIVETURNL");
+      return solveFrm(T_DIVETURNL);
     if(bool(wlkMode & WalkBit::WM_Swim))
-      return solveFrm("T_SWIMTURNL");
+      return solveFrm(T_SWIMTURNL);
     if(bool(wlkMode & WalkBit::WM_Sneak))
-      return solveFrm("T_SNEAKTURNL");
+      return solveFrm(T_SNEAKTURNL);
     if(bool(wlkMode & WalkBit::WM_Walk))
-      return solveFrm("T_%sWALKTURNL",st);
+      return solveFrm(T_xWALKTURNL);
     if(bool(wlkMode & WalkBit::WM_Water))
-      return solveFrm("T_%sWALKWTURNL",st);
-    return solveFrm("T_%sRUNTURNL",st);
+      return solveFrm(T_xWALKWTURNL);
+    return solveFrm(T_xRUNTURNL);
     }
   if(a==RotR) {
     if(bool(wlkMode & WalkBit::WM_Dive))
-      return solveFrm("T_DIVETURNR");
+      return solveFrm(T_DIVETURNR);
     if(bool(wlkMode & WalkBit::WM_Swim))
-      return solveFrm("T_SWIMTURNR");
+      return solveFrm(T_SWIMTURNR);
     if(bool(wlkMode & WalkBit::WM_Sneak))
-      return solveFrm("T_SNEAKTURNR");
+      return solveFrm(T_SNEAKTURNR);
     if(bool(wlkMode & WalkBit::WM_Walk))
-      return solveFrm("T_%sWALKTURNR",st);
+      return solveFrm(T_xWALKTURNR);
     if(bool(wlkMode & WalkBit::WM_Water))
-      return solveFrm("T_%sWALKWTURNR",st);
-    return solveFrm("T_%sRUNTURNR",st);
+      return solveFrm(T_xWALKWTURNR);
+    return solveFrm(T_xRUNTURNR);
     }
   // Jump regular
   if(a==Jump)
-    return solveFrm("S_JUMP");
+    return solveFrm(S_JUMP);
   if(a==JumpUpLow)
-    return solveFrm("S_JUMPUPLOW");
+    return solveFrm(S_JUMPUPLOW);
   if(a==JumpUpMid)
-    return solveFrm("S_JUMPUPMID");
+    return solveFrm(S_JUMPUPMID);
   if(a==JumpUp)
-    return solveFrm("S_JUMPUP");
+    return solveFrm(S_JUMPUP);
 
   if(a==JumpHang) {
-    if(pose.bodyState()==BS_JUMP) {
-      if(auto ret = solveFrm("T_JUMPUP_2_HANG"))
+    if(pose->bodyState()==BS_JUMP) {
+      if(auto ret = solveFrm(T_JUMPUP_2_HANG))
         return ret;
       }
     //return solveFrm("S_HANG");
-    return solveFrm("T_HANG_2_STAND");
+    return solveFrm(T_HANG_2_STAND);
     }
 
   if(a==Anim::Fall)
-    return solveFrm("S_FALLDN");
+    return solveFrm(S_FALLDN);
 
   if(a==Anim::Fallen) {
-    if(pose.isInAnim("S_FALL") || pose.isInAnim("S_FALLEN"))
-      return solveFrm("S_FALLEN");
-    if(pose.isInAnim("S_FALLB") || pose.isInAnim("S_FALLENB"))
-      return solveFrm("S_FALLENB");
-    return solveFrm("S_FALLEN");
+    if(b.isInAnim(*pose,In_FALL))
+      return solveFrm(S_FALLEN);
+    if(b.isInAnim(*pose,In_FALLB))
+      return solveFrm(S_FALLENB);
+    return solveFrm(S_FALLEN);
     }
   if(a==Anim::FallenA)
-    return solveFrm("S_FALLEN");
+    return solveFrm(S_FALLEN);
   if(a==Anim::FallenB)
-    return solveFrm("S_FALLENB");
+    return solveFrm(S_FALLENB);
 
   if(a==Anim::FallDeep) {
-    if(pose.bodyState()==BS_FALL || pose.bodyState()==BS_JUMP)
-      return solveFrm("S_FALL");
-    return solveFrm("S_FALLB");
+    if(pose->bodyState()==BS_FALL || pose->bodyState()==BS_JUMP)
+      return solveFrm(S_FALL);
+    return solveFrm(S_FALLB);
     }
   if(a==Anim::FallDeepA)
-    return solveFrm("S_FALL");
+    return solveFrm(S_FALL);
   if(a==Anim::FallDeepB)
-    return solveFrm("S_FALLB");
+    return solveFrm(S_FALLB);
 
   if(a==Anim::SlideA)
-    return solveFrm("S_SLIDE");
+    return solveFrm(S_SLIDE);
   if(a==Anim::SlideB)
-    return solveFrm("S_SLIDEB");
+    return solveFrm(S_SLIDEB);
   if(a==Anim::StumbleA)
-    return solveFrm("T_STUMBLE");
+    return solveFrm(T_STUMBLE);
   if(a==Anim::StumbleB)
-    return solveFrm("T_STUMBLEB");
+    return solveFrm(T_STUMBLEB);
   if(a==Anim::DeadA) {
-    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
-       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
-      return solveDead("T_WOUNDED_2_DEAD","T_WOUNDEDB_2_DEADB");
-    if(pose.bodyState()==BS_FALL)
-      return solveDead("T_DEAD", "T_DEADB");
-    if(pose.hasAnim())
-      return solveDead("T_DEAD", "T_DEADB");
-    return solveDead("S_DEAD", "S_DEADB");
+    if(b.isInAnim(*pose,In_WOUNDED))
+      return solveDead(T_WOUNDED_2_DEAD,T_WOUNDEDB_2_DEADB);
+    if(pose->bodyState()==BS_FALL)
+      return solveDead(T_DEAD,T_DEADB);
+    if(pose->hasAnim())
+      return solveDead(T_DEAD,T_DEADB);
+    return solveDead(S_DEAD,S_DEADB);
     }
   if(a==Anim::DeadB) {
-    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
-       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
-      return solveDead("T_WOUNDEDB_2_DEADB","T_WOUNDED_2_DEAD");
-    if(pose.hasAnim())
-      return solveDead("T_DEADB","T_DEAD"); else
-      return solveDead("S_DEADB","S_DEAD");
+    if(b.isInAnim(*pose,In_WOUNDED))
+      return solveDead(T_WOUNDEDB_2_DEADB,T_WOUNDED_2_DEAD);
+    if(pose->hasAnim())
+      return solveDead(T_DEADB,T_DEAD); else
+      return solveDead(S_DEADB,S_DEAD);
     }
 
   if(a==Anim::UnconsciousA)
-    return solveFrm("T_STAND_2_WOUNDED");
+    return solveFrm(T_STAND_2_WOUNDED);
   if(a==Anim::UnconsciousB)
-    return solveFrm("T_STAND_2_WOUNDEDB");
+    return solveFrm(T_STAND_2_WOUNDEDB);
 
   if(a==Anim::ItmGet)
-    return solveFrm("S_IGET");
+    return solveFrm(S_IGET);
   if(a==Anim::ItmDrop)
-    return solveFrm("S_IDROP");
+    return solveFrm(S_IDROP);
   if(a==Anim::PointAt)
-    return solveFrm("T_POINT");
+    return solveFrm(T_POINT);
 
   return nullptr;
   }
@@ -367,11 +500,12 @@ const Animation::Sequence *AnimationSolver::solveAnim(WeaponState st, WeaponStat
   // Weapon draw/undraw
   if(st==cur)
     return nullptr;
+  auto& b = binding();
   switch(st) {
     case WeaponState::NoWeapon:
       if(run)
-        return solveFrm("T_%sMOVE_2_MOVE",cur);
-      return solveFrm("T_%sRUN_2_%s",cur);
+        return b.frm[T_xMOVE_2_MOVE][int(cur)];
+      return b.frm[T_xRUN_2_x][int(cur)];
     case WeaponState::Fist:
     case WeaponState::Mage:
     case WeaponState::W1H:
@@ -379,30 +513,43 @@ const Animation::Sequence *AnimationSolver::solveAnim(WeaponState st, WeaponStat
     case WeaponState::Bow:
     case WeaponState::CBow:
       if(run)
-        return solveFrm("T_MOVE_2_%sMOVE",st);
-      return solveFrm("T_%s_2_%sRUN",st);
+        return b.frm[T_MOVE_2_xMOVE][int(st)];
+      return b.frm[T_x_2_xRUN][int(st)];
     }
   return nullptr;
   }
 
 const Animation::Sequence* AnimationSolver::solveAnim(std::string_view scheme, bool run, bool invest) const {
-  // example: "T_MAGWALK_2_FBTSHOOT"
-
-  string_frm name("");
-  if(run && invest)
-    name = string_frm("T_MAGMOVE_2_",scheme,"CAST");
-  else if(run)
-    name = string_frm("T_MAGMOVE_2_",scheme,"SHOOT");
-  else if(run)
-    name = string_frm("T_MAGRUN_2_",scheme,"CAST");
-  else
-    name = string_frm("T_MAGRUN_2_",scheme,"SHOOT");
+  auto& b = binding();
+  std::lock_guard<std::mutex> guard(b.magSync);
+  auto it = b.mag.find(scheme);
+  if(it==b.mag.end())
+    it = b.mag.emplace(std::string(scheme),solveMag(scheme)).first;
+  return it->second.sq[(run ? 2 : 0) + (invest ? 1 : 0)];
+  }
 
-  if(auto sq = solveFrm(name))
-    return sq;
+AnimationSolver::Mag AnimationSolver::solveMag(std::string_view scheme) const {
+  // example: "T_MAGWALK_2_FBTSHOOT"
+  Mag ret;
+  for(int i=0; i<4; ++i) {
+    const bool run    = (i&2);
+    const bool invest = (i&1);
+
+    string_frm name("");
+    if(run && invest)
+      name = string_frm("T_MAGMOVE_2_",scheme,"CAST");
+    else if(run)
+      name = string_frm("T_MAGMOVE_2_",scheme,"SHOOT");
+    else if(run)
+      name = string_frm("T_MAGRUN_2_",scheme,"CAST");
+    else
+      name = string_frm("T_MAGRUN_2_",scheme,"SHOOT");
 
-  name = string_frm("S_",scheme,"SHOOT");
-  return solveFrm(name);
+    ret.sq[i] = solveFrm(name);
+    if(ret.sq[i]==nullptr)
+      ret.sq[i] = solveFrm(string_frm("S_",scheme,"SHOOT"));
+    }
+  return ret;
   }
 
 const Animation::Sequence *AnimationSolver::solveAnim(Interactive *inter, AnimationSolver::Anim a, const Pose &) const {
@@ -446,23 +593,69 @@ const Animation::Sequence* AnimationSolver::solveFrm(std::string_view fview, Wea
   return solveFrm(name);
   }
 
-const Animation::Sequence* AnimationSolver::solveMag(std::string_view fview, std::string_view spell) const {
-  char format[256] = {};
-  std::snprintf(format,sizeof(format),"%.*s",int(fview.size()),fview.data());
-
-  char name[128]={};
-  std::snprintf(name,sizeof(name),format,std::string(spell).c_str()); //FIXME
-  return solveFrm(name);
+void AnimationSolver::invalidateCache() {
+  bind = nullptr;
   }
 
-const Animation::Sequence *AnimationSolver::solveDead(std::string_view format1, std::string_view format2) const {
-  if(auto a=solveFrm(format1))
-    return a;
-  return solveFrm(format2);
+const AnimationSolver::Bind& AnimationSolver::binding() const {
+  if(bind==nullptr)
+    bind = mkBinding();
+  return *bind;
   }
 
-void AnimationSolver::invalidateCache() {
-  std::memset(cache,0,sizeof(cache));
+std::shared_ptr<const AnimationSolver::Bind> AnimationSolver::mkBinding() const {
+  static std::mutex                             sync;
+  static std::vector<std::weak_ptr<const Bind>> binds;
+
+  std::lock_guard<std::mutex> guard(sync);
+  for(size_t i=0; i<binds.size();) {
+    auto b = binds[i].lock();
+    if(b==nullptr) {
+      binds[i] = std::move(binds.back());
+      binds.pop_back();
+      continue;
+      }
+    ++i;
+    if(b->baseSk!=baseSk || b->overlay.size()!=overlay.size())
+      continue;
+    bool eq = true;
+    for(size_t r=0; r<overlay.size() && eq; ++r)
+      eq = (b->overlay[r]==overlay[r].skeleton);
+    if(eq)
+      return b;
+    }
+
+  auto b = std::make_shared<Bind>();
+  b->baseSk = baseSk;
+  for(auto& i:overlay)
+    b->overlay.push_back(i.skeleton);
+
+  for(uint8_t f=0; f<FrmCount; ++f)
+    for(uint8_t st=0; st<WeaponCount; ++st)
+      b->frm[f][st] = solveFrm(frmName[f],WeaponState(st));
+
+  for(uint8_t a=0; a<InAnimCount; ++a)
+    for(auto name:inAnimName[a]) {
+      if(name==nullptr)
+        break;
+      for(auto& i:overlay)
+        if(auto s = i.skeleton->sequence(name))
+          b->inAnim[a].push_back(s);
+      if(baseSk!=nullptr)
+        if(auto s = baseSk->sequence(name))
+          b->inAnim[a].push_back(s);
+      }
+
+  for(uint16_t a=0; a<AnimCount; ++a)
+    for(uint8_t st=0; st<WeaponCount; ++st)
+      for(uint8_t wlk=0; wlk<WalkCount; ++wlk) {
+        if(isPoseDependent(Anim(a),walkClassBit[wlk]))
+          continue;
+        b->anim[a][st][wlk] = implSolveAnim(*b,Anim(a),WeaponState(st),walkClassBit[wlk],nullptr);
+        }
+
+  binds.push_back(b);
+  return b;
   }
 
 const Animation::Sequence* AnimationSolver::solveNext(const Animation::Sequence& sq) const {
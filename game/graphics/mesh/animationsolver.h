@@ -2,6 +2,7 @@
 
 #include <Tempest/Matrix4x4>
 #include <vector>
+#include <memory>
 
 #include "game/constants.h"
 #include "animation.h"
@@ -21,7 +22,6 @@ class AnimationSolver final {
       NoAnim,
       Idle,
       Move,
-      CacheLast = Move,
 
       MoveBack,
       MoveL,
@@ -95,16 +95,23 @@ class AnimationSolver final {
     const Animation::Sequence*     solveAnim(Interactive *inter, Anim a, const Pose &pose) const;
 
   private:
+    struct Bind;
+    struct Mag;
+
     const Animation::Sequence*     solveFrm    (std::string_view format, WeaponState st) const;
+    Mag                            solveMag    (std::string_view scheme) const;
 
-    const Animation::Sequence*     solveMag    (std::string_view format, std::string_view spell) const;
-    const Animation::Sequence*     solveDead   (std::string_view format1, std::string_view format2) const;
+    static bool                    isPoseDependent(Anim a, WalkBit wlk);
+    static uint8_t                 walkClass(WalkBit wlk);
 
-    const Animation::Sequence*     implSolveAnim(Anim a, WeaponState st, WalkBit wlk, const Pose &pose) const;
+    static const Animation::Sequence* implSolveAnim(const Bind& b, Anim a, WeaponState st, WalkBit wlk, const Pose* pose);
+    const Bind&                    binding() const;
+    std::shared_ptr<const Bind>    mkBinding() const;
     void                           invalidateCache();
 
     const Skeleton*                baseSk=nullptr;
     std::vector<Overlay>           overlay;
 
-    mutable const Animation::Sequence* cache [CacheLast][2][2] = {};
+    // resolved sequences for current skeleton + overlay set; shared between solvers with the same set
+    mutable std::shared_ptr<const Bind> bind;
   };
@@ -1,6 +1,7 @@
 #include "animmath.h"
 
 #include <cmath>
+#include <cstring>
 
 static float mix(float x,float y,float a){
   return x+(y-x)*a;
@@ -43,3 +44,267 @@ Tempest::Matrix4x4 mkMatrix(const zenkit::AnimationSample& s) {
   return mkMatrix(s.rotation.x,s.rotation.y,s.rotation.z,s.rotation.w,
                   s.position.x,s.position.y,s.position.z);
   }
+
+// mixSamples: nlerp with corrected parameter follows slerp closely (fit from "Approximating slerp", A. Kapoulkine)
+// at = a + slerpK0*(A(d)*slerpK1 + B(d)), d = |dot(x,y)|
+static float slerpK0(float a) { return a*(a-0.5f)*(a-1.f); }
+static float slerpK1(float a) { return (a-0.5f)*(a-0.5f); }
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+
+void mixSamples(const float* x, size_t sx, const float* y, size_t sy, float a, float* out, size_t so, size_t count) {
+  const __m128 va  = _mm_set1_ps(a);
+  const __m128 neg = _mm_set1_ps(-0.f);
+  const __m128 k0  = _mm_set1_ps(slerpK0(a));
+  const __m128 k1  = _mm_set1_ps(slerpK1(a));
+  auto poly = [](__m128 d, float c0, float c1, float c2) {
+    return _mm_add_ps(_mm_set1_ps(c0),_mm_mul_ps(d,_mm_add_ps(_mm_set1_ps(c1),_mm_mul_ps(d,_mm_set1_ps(c2)))));
+    };
+  for(size_t i=0; i<count; i+=4) {
+    for(size_t p=0; p<3; ++p) {
+      const __m128 px = _mm_loadu_ps(x+p*sx+i);
+      const __m128 py = _mm_loadu_ps(y+p*sy+i);
+      _mm_storeu_ps(out+p*so+i, _mm_add_ps(px,_mm_mul_ps(_mm_sub_ps(py,px),va)));
+      }
+
+    __m128 qx[4], qy[4];
+    for(size_t c=0; c<4; ++c) {
+      qx[c] = _mm_loadu_ps(x+(3+c)*sx+i);
+      qy[c] = _mm_loadu_ps(y+(3+c)*sy+i);
+      }
+    __m128 dot = _mm_mul_ps(qx[0],qy[0]);
+    for(size_t c=1; c<4; ++c)
+      dot = _mm_add_ps(dot,_mm_mul_ps(qx[c],qy[c]));
+    // shortest arc: flip y, where dot<0
+    const __m128 sign = _mm_and_ps(dot,neg);
+    const __m128 d    = _mm_andnot_ps(neg,dot);
+    const __m128 ka   = _mm_add_ps(_mm_set1_ps(1.0904f),_mm_mul_ps(d,poly(d,-3.2452f,3.55645f,-1.43519f)));
+    const __m128 kb   = poly(d,0.848013f,-1.06021f,0.215638f);
+    const __m128 at   = _mm_add_ps(va,_mm_mul_ps(k0,_mm_add_ps(_mm_mul_ps(ka,k1),kb)));
+
+    __m128 q[4], len = _mm_setzero_ps();
+    for(size_t c=0; c<4; ++c) {
+      const __m128 yc = _mm_xor_ps(qy[c],sign);
+      q[c] = _mm_add_ps(qx[c],_mm_mul_ps(_mm_sub_ps(yc,qx[c]),at));
+      len  = _mm_add_ps(len,_mm_mul_ps(q[c],q[c]));
+      }
+    const __m128 inv = _mm_div_ps(_mm_set1_ps(1.f),_mm_sqrt_ps(len));
+    for(size_t c=0; c<4; ++c)
+      _mm_storeu_ps(out+(3+c)*so+i, _mm_mul_ps(q[c],inv));
+    }
+  }
+
+void selectSamples(const float* x, size_t sx, const uint32_t* mask, float* out, size_t so, size_t count) {
+  for(size_t i=0; i<count; i+=4) {
+    const __m128 m = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask+i)));
+    for(size_t p=0; p<SamplePlanes; ++p) {
+      const __m128 vx = _mm_loadu_ps(x+p*sx+i);
+      const __m128 vo = _mm_loadu_ps(out+p*so+i);
+      _mm_storeu_ps(out+p*so+i, _mm_or_ps(_mm_and_ps(m,vx),_mm_andnot_ps(m,vo)));
+      }
+    }
+  }
+
+void mkMatrices(const float* s, size_t stride, size_t count, Tempest::Matrix4x4* out) {
+  const __m128 two  = _mm_set1_ps(2.f);
+  const __m128 zero = _mm_setzero_ps();
+  for(size_t i=0; i<count; i+=4) {
+    const __m128 x  = _mm_loadu_ps(s+3*stride+i);
+    const __m128 y  = _mm_loadu_ps(s+4*stride+i);
+    const __m128 z  = _mm_loadu_ps(s+5*stride+i);
+    const __m128 w  = _mm_loadu_ps(s+6*stride+i);
+    const __m128 xx = _mm_mul_ps(x,x), yy = _mm_mul_ps(y,y), zz = _mm_mul_ps(z,z), ww = _mm_mul_ps(w,w);
+    const __m128 xy = _mm_mul_ps(x,y), xz = _mm_mul_ps(x,z), yz = _mm_mul_ps(y,z);
+    const __m128 wx = _mm_mul_ps(w,x), wy = _mm_mul_ps(w,y), wz = _mm_mul_ps(w,z);
+
+    __m128 r[4][4] = {
+      {_mm_sub_ps(_mm_add_ps(ww,xx),_mm_add_ps(yy,zz)), _mm_mul_ps(two,_mm_sub_ps(xy,wz)), _mm_mul_ps(two,_mm_add_ps(xz,wy)), zero},
+      {_mm_mul_ps(two,_mm_add_ps(xy,wz)), _mm_sub_ps(_mm_add_ps(ww,yy),_mm_add_ps(xx,zz)), _mm_mul_ps(two,_mm_sub_ps(yz,wx)), zero},
+      {_mm_mul_ps(two,_mm_sub_ps(xz,wy)), _mm_mul_ps(two,_mm_add_ps(yz,wx)), _mm_sub_ps(_mm_add_ps(ww,zz),_mm_add_ps(xx,yy)), zero},
+      {_mm_loadu_ps(s+0*stride+i), _mm_loadu_ps(s+1*stride+i), _mm_loadu_ps(s+2*stride+i), _mm_set1_ps(1.f)},
+      };
+
+    float m[4][16];
+    for(size_t row=0; row<4; ++row) {
+      _MM_TRANSPOSE4_PS(r[row][0],r[row][1],r[row][2],r[row][3]);
+      for(size_t l=0; l<4; ++l)
+        _mm_storeu_ps(m[l]+row*4, r[row][l]);
+      }
+    for(size_t l=0; l<4; ++l)
+      out[i+l] = Tempest::Matrix4x4(m[l]);
+    }
+  }
+
+Tempest::Matrix4x4 mulMatrix(const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b) {
+  const float* ma = a.data();
+  const float* mb = b.data();
+  const __m128 c0 = _mm_loadu_ps(ma+0);
+  const __m128 c1 = _mm_loadu_ps(ma+4);
+  const __m128 c2 = _mm_loadu_ps(ma+8);
+  const __m128 c3 = _mm_loadu_ps(ma+12);
+
+  float r[16];
+  for(size_t i=0; i<4; ++i) {
+    __m128 v = _mm_mul_ps(c0,_mm_set1_ps(mb[i*4+0]));
+    v = _mm_add_ps(v,_mm_mul_ps(c1,_mm_set1_ps(mb[i*4+1])));
+    v = _mm_add_ps(v,_mm_mul_ps(c2,_mm_set1_ps(mb[i*4+2])));
+    v = _mm_add_ps(v,_mm_mul_ps(c3,_mm_set1_ps(mb[i*4+3])));
+    _mm_storeu_ps(r+i*4,v);
+    }
+  return Tempest::Matrix4x4(r);
+  }
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+
+void mixSamples(const float* x, size_t sx, const float* y, size_t sy, float a, float* out, size_t so, size_t count) {
+  const float32x4_t va = vdupq_n_f32(a);
+  const float32x4_t k0 = vdupq_n_f32(slerpK0(a));
+  const float32x4_t k1 = vdupq_n_f32(slerpK1(a));
+  auto poly = [](float32x4_t d, float c0, float c1, float c2) {
+    return vmlaq_f32(vdupq_n_f32(c0),d,vmlaq_f32(vdupq_n_f32(c1),d,vdupq_n_f32(c2)));
+    };
+  for(size_t i=0; i<count; i+=4) {
+    for(size_t p=0; p<3; ++p) {
+      const float32x4_t px = vld1q_f32(x+p*sx+i);
+      const float32x4_t py = vld1q_f32(y+p*sy+i);
+      vst1q_f32(out+p*so+i, vmlaq_f32(px,vsubq_f32(py,px),va));
+      }
+
+    float32x4_t qx[4], qy[4];
+    for(size_t c=0; c<4; ++c) {
+      qx[c] = vld1q_f32(x+(3+c)*sx+i);
+      qy[c] = vld1q_f32(y+(3+c)*sy+i);
+      }
+    float32x4_t dot = vmulq_f32(qx[0],qy[0]);
+    for(size_t c=1; c<4; ++c)
+      dot = vmlaq_f32(dot,qx[c],qy[c]);
+    // shortest arc: flip y, where dot<0
+    const uint32x4_t  sign = vandq_u32(vreinterpretq_u32_f32(dot),vdupq_n_u32(0x80000000u));
+    const float32x4_t d    = vabsq_f32(dot);
+    const float32x4_t ka   = vmlaq_f32(vdupq_n_f32(1.0904f),d,poly(d,-3.2452f,3.55645f,-1.43519f));
+    const float32x4_t kb   = poly(d,0.848013f,-1.06021f,0.215638f);
+    const float32x4_t at   = vmlaq_f32(va,k0,vmlaq_f32(kb,ka,k1));
+
+    float32x4_t q[4], len = vdupq_n_f32(0);
+    for(size_t c=0; c<4; ++c) {
+      const float32x4_t yc = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(qy[c]),sign));
+      q[c] = vmlaq_f32(qx[c],vsubq_f32(yc,qx[c]),at);
+      len  = vmlaq_f32(len,q[c],q[c]);
+      }
+    float l[4], inv[4];
+    vst1q_f32(l,len);
+    for(size_t c=0; c<4; ++c)
+      inv[c] = 1.f/std::sqrt(l[c]);
+    const float32x4_t vinv = vld1q_f32(inv);
+    for(size_t c=0; c<4; ++c)
+      vst1q_f32(out+(3+c)*so+i, vmulq_f32(q[c],vinv));
+    }
+  }
+
+void selectSamples(const float* x, size_t sx, const uint32_t* mask, float* out, size_t so, size_t count) {
+  for(size_t i=0; i<count; i+=4) {
+    const uint32x4_t m = vld1q_u32(mask+i);
+    for(size_t p=0; p<SamplePlanes; ++p)
+      vst1q_f32(out+p*so+i, vbslq_f32(m,vld1q_f32(x+p*sx+i),vld1q_f32(out+p*so+i)));
+    }
+  }
+
+void mkMatrices(const float* s, size_t stride, size_t count, Tempest::Matrix4x4* out) {
+  const float32x4_t zero = vdupq_n_f32(0);
+  for(size_t i=0; i<count; i+=4) {
+    const float32x4_t x  = vld1q_f32(s+3*stride+i);
+    const float32x4_t y  = vld1q_f32(s+4*stride+i);
+    const float32x4_t z  = vld1q_f32(s+5*stride+i);
+    const float32x4_t w  = vld1q_f32(s+6*stride+i);
+    const float32x4_t xx = vmulq_f32(x,x), yy = vmulq_f32(y,y), zz = vmulq_f32(z,z), ww = vmulq_f32(w,w);
+    const float32x4_t xy = vmulq_f32(x,y), xz = vmulq_f32(x,z), yz = vmulq_f32(y,z);
+    const float32x4_t wx = vmulq_f32(w,x), wy = vmulq_f32(w,y), wz = vmulq_f32(w,z);
+
+    const float32x4x4_t r[4] = {
+      {{vsubq_f32(vaddq_f32(ww,xx),vaddq_f32(yy,zz)), vmulq_n_f32(vsubq_f32(xy,wz),2.f), vmulq_n_f32(vaddq_f32(xz,wy),2.f), zero}},
+      {{vmulq_n_f32(vaddq_f32(xy,wz),2.f), vsubq_f32(vaddq_f32(ww,yy),vaddq_f32(xx,zz)), vmulq_n_f32(vsubq_f32(yz,wx),2.f), zero}},
+      {{vmulq_n_f32(vsubq_f32(xz,wy),2.f), vmulq_n_f32(vaddq_f32(yz,wx),2.f), vsubq_f32(vaddq_f32(ww,zz),vaddq_f32(xx,yy)), zero}},
+      {{vld1q_f32(s+0*stride+i), vld1q_f32(s+1*stride+i), vld1q_f32(s+2*stride+i), vdupq_n_f32(1.f)}},
+      };
+
+    // vst4q_f32 interleaves: row of lane l lands at [l*4, l*4+4)
+    float t[4][16], m[16];
+    for(size_t row=0; row<4; ++row)
+      vst4q_f32(t[row],r[row]);
+    for(size_t l=0; l<4; ++l) {
+      for(size_t row=0; row<4; ++row)
+        std::memcpy(m+row*4, t[row]+l*4, 4*sizeof(float));
+      out[i+l] = Tempest::Matrix4x4(m);
+      }
+    }
+  }
+
+Tempest::Matrix4x4 mulMatrix(const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b) {
+  const float*      ma = a.data();
+  const float*      mb = b.data();
+  const float32x4_t c0 = vld1q_f32(ma+0);
+  const float32x4_t c1 = vld1q_f32(ma+4);
+  const float32x4_t c2 = vld1q_f32(ma+8);
+  const float32x4_t c3 = vld1q_f32(ma+12);
+
+  float r[16];
+  for(size_t i=0; i<4; ++i) {
+    float32x4_t v = vmulq_n_f32(c0,mb[i*4+0]);
+    v = vmlaq_n_f32(v,c1,mb[i*4+1]);
+    v = vmlaq_n_f32(v,c2,mb[i*4+2]);
+    v = vmlaq_n_f32(v,c3,mb[i*4+3]);
+    vst1q_f32(r+i*4,v);
+    }
+  return Tempest::Matrix4x4(r);
+  }
+
+#else
+
+void mixSamples(const float* x, size_t sx, const float* y, size_t sy, float a, float* out, size_t so, size_t count) {
+  for(size_t i=0; i<count; ++i) {
+    for(size_t p=0; p<3; ++p)
+      out[p*so+i] = mix(x[p*sx+i],y[p*sy+i],a);
+
+    float dot = 0;
+    for(size_t c=3; c<7; ++c)
+      dot += x[c*sx+i]*y[c*sy+i];
+    const float sign = dot<0.f ? -1.f : 1.f;
+    const float d    = std::abs(dot);
+    const float ka   = 1.0904f + d*(-3.2452f + d*(3.55645f - d*1.43519f));
+    const float kb   = 0.848013f + d*(-1.06021f + d*0.215638f);
+    const float at   = a + slerpK0(a)*(ka*slerpK1(a) + kb);
+
+    float len = 0;
+    for(size_t c=3; c<7; ++c) {
+      const float q = mix(x[c*sx+i],sign*y[c*sy+i],at);
+      out[c*so+i] = q;
+      len += q*q;
+      }
+    const float inv = 1.f/std::sqrt(len);
+    for(size_t c=3; c<7; ++c)
+      out[c*so+i] *= inv;
+    }
+  }
+
+void selectSamples(const float* x, size_t sx, const uint32_t* mask, float* out, size_t so, size_t count) {
+  for(size_t i=0; i<count; ++i) {
+    if(mask[i]==0)
+      continue;
+    for(size_t p=0; p<SamplePlanes; ++p)
+      out[p*so+i] = x[p*sx+i];
+    }
+  }
+
+void mkMatrices(const float* s, size_t stride, size_t count, Tempest::Matrix4x4* out) {
+  for(size_t i=0; i<count; ++i)
+    out[i] = mkMatrix(s[3*stride+i],s[4*stride+i],s[5*stride+i],s[6*stride+i],
+                      s[0*stride+i],s[1*stride+i],s[2*stride+i]);
+  }
+
+Tempest::Matrix4x4 mulMatrix(const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b) {
+  return a*b;
+  }
+
+#endif
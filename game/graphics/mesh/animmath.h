@@ -4,6 +4,23 @@
 #include <Tempest/Point>
 
 #include <zenkit/ModelAnimation.hh>
+#include <cstdint>
+
+// planar(SoA) sample layout: position xyz + rotation xyzw, each plane is 'stride' floats; lane i is skeleton node i
+// strides and lane counts are multiples of 4, so kernels below can process 4 bones at once
+enum : size_t {
+  SamplePlanes = 7,
+  };
 
 zenkit::AnimationSample mix(const zenkit::AnimationSample& x, const zenkit::AnimationSample& y, float a);
 Tempest::Matrix4x4      mkMatrix(const zenkit::AnimationSample& s);
+
+// lerp of positions and slerp of rotations; slerp is approximated within 0.1 degree
+void                    mixSamples   (const float* x, size_t sx, const float* y, size_t sy, float a,
+                                      float* out, size_t so, size_t count);
+// out = mask ? x : out, for every plane; mask lanes are 0 or ~0u
+void                    selectSamples(const float* x, size_t sx, const uint32_t* mask,
+                                      float* out, size_t so, size_t count);
+// local bone transforms of 'count' lanes
+void                    mkMatrices   (const float* s, size_t stride, size_t count, Tempest::Matrix4x4* out);
+Tempest::Matrix4x4      mulMatrix    (const Tempest::Matrix4x4& a, const Tempest::Matrix4x4& b);
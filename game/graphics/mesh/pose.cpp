@@ -59,10 +59,10 @@ void Pose::save(Serialize &fout) {
 
   for(auto& i:hasSamples)
     fout.write(uint8_t(i));
-  for(auto& i:base)
-    fout.write(i);
-  for(auto& i:prev)
-    fout.write(i);
+  for(size_t i=0; i<MaxBones; ++i)
+    fout.write(sample(base,i));
+  for(size_t i=0; i<MaxBones; ++i)
+    fout.write(sample(prev,i));
   for(auto& i:tr)
     fout.write(i);
   }
@@ -101,10 +101,15 @@ void Pose::load(Serialize &fin, const AnimationSolver& solver) {
   numBones = skeleton==nullptr ? 0 : skeleton->nodes.size();
   for(auto& i:hasSamples)
     fin.read(reinterpret_cast<uint8_t&>(i));
-  for(auto& i:base)
-    fin.read(i);
-  for(auto& i:prev)
-    fin.read(i);
+  zenkit::AnimationSample smp;
+  for(size_t i=0; i<MaxBones; ++i) {
+    fin.read(smp);
+    setSample(base,i,smp);
+    }
+  for(size_t i=0; i<MaxBones; ++i) {
+    fin.read(smp);
+    setSample(prev,i,smp);
+    }
   for(auto& i:tr)
     fin.read(i);
   }
@@ -347,7 +352,8 @@ bool Pose::updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBle
   auto&        d         = *s.data;
   const size_t numFrames = d.numFrames;
   const size_t idSize    = d.nodeIndex.size();
-  if(numFrames==0 || idSize==0 || d.samples.size()%idSize!=0)
+  const size_t stride    = d.sampleStride;
+  if(numFrames==0 || idSize==0 || d.samples.size()<numFrames*SamplePlanes*stride)
     return false;
   if(numFrames==1 && !needToUpdate)
     return false;
@@ -375,44 +381,47 @@ bool Pose::updateFrame(const Animation::Sequence &s, BodyState bs, uint64_t sBle
     frameB = d.numFrames-1-frameB;
     }
 
-  auto* sampleA = &d.samples[size_t(frameA*idSize)];
-  auto* sampleB = &d.samples[size_t(frameB*idSize)];
+  auto* sampleA = &d.samples[size_t(frameA*SamplePlanes*stride)];
+  auto* sampleB = &d.samples[size_t(frameB*SamplePlanes*stride)];
 
-  const uint64_t blendMax = std::max(s.blendOut,s.blendIn);
-  const uint64_t blend    = std::max<uint64_t>(0, now-sBlend);
+  // lanes are skeleton nodes: frame, blend and compose stay planar
+  const size_t count = std::min({stride, (numBones+3) & ~size_t(3), size_t(MaxBones)});
+  float        cur[SamplePlanes*MaxBones];
+  mixSamples(sampleA,stride,sampleB,stride,a,cur,MaxBones,count);
 
-  for(size_t i=0; i<idSize; ++i) {
-    size_t idx = d.nodeIndex[i];
-    if(idx>=numBones)
-      continue;
-    auto smp = mix(sampleA[i],sampleB[i],a);
-    if(i==0) {
-      if(bs==BS_CLIMB)
-        smp.position.y = trY;
-      else if(s.isFly())
-        smp.position.y = d.translate.y;
-      }
+  const size_t root = d.nodeIndex[0];
+  if(root<count) {
+    if(bs==BS_CLIMB)
+      cur[1*MaxBones+root] = trY;
+    else if(s.isFly())
+      cur[1*MaxBones+root] = d.translate.y;
+    }
 
-    switch(hasSamples[idx]) {
-      case S_None:
-        hasSamples[idx] = S_Old;
-        base      [idx] = smp;
-        break;
-      case S_Old:
-        hasSamples[idx] = S_Valid;
-        prev      [idx] = base[idx];
-        [[fallthrough]];
-      case S_Valid:
-        if(blend < blendMax) {
-          float a2 = float(blend)/float(blendMax);
-          assert(0.f<=a2 && a2<=1.f);
-          base[idx] = mix(prev[idx],smp,a2);
-          } else {
-          prev[idx] = smp;
-          base[idx] = smp;
-          }
-        break;
-      }
+  uint32_t upd[MaxBones], none[MaxBones], old[MaxBones];
+  for(size_t i=0; i<count; ++i) {
+    const bool u = i<numBones && d.sampleMask[i]!=0;
+    upd [i] = u                            ? ~0u : 0u;
+    none[i] = (u && hasSamples[i]==S_None) ? ~0u : 0u;
+    old [i] = (u && hasSamples[i]==S_Old)  ? ~0u : 0u;
+    if(u)
+      hasSamples[i] = (hasSamples[i]==S_None ? S_Old : S_Valid);
+    }
+  // S_Old: blend from the last pose
+  selectSamples(base,MaxBones,old,prev,MaxBones,count);
+
+  const uint64_t blendMax = std::max(s.blendOut,s.blendIn);
+  const uint64_t blend    = std::max<uint64_t>(0, now-sBlend);
+  if(blend < blendMax) {
+    float a2 = float(blend)/float(blendMax);
+    assert(0.f<=a2 && a2<=1.f);
+    float mixed[SamplePlanes*MaxBones];
+    mixSamples(prev,MaxBones,cur,MaxBones,a2,mixed,MaxBones,count);
+    // S_None: nothing to blend from
+    selectSamples(cur,  MaxBones,none,mixed,MaxBones,count);
+    selectSamples(mixed,MaxBones,upd, base, MaxBones,count);
+    } else {
+    selectSamples(cur,  MaxBones,upd, base, MaxBones,count);
+    selectSamples(cur,  MaxBones,upd, prev, MaxBones,count);
     }
   return true;
   }
@@ -432,13 +441,15 @@ void Pose::implMkSkeleton(const Matrix4x4 &mt) {
     return;
   auto& nodes      = skeleton->nodes;
   auto  BIP01_HEAD = skeleton->BIP01_HEAD;
+  Matrix4x4 local[MaxBones];
+  mkMatrices(base,MaxBones,std::min((nodes.size()+3) & ~size_t(3),size_t(MaxBones)),local);
   for(size_t i=0; i<nodes.size(); ++i) {
     size_t parent = nodes[i].parent;
-    auto   mat    = hasSamples[i] ? mkMatrix(base[i]) : nodes[i].tr;
+    auto&  mat    = hasSamples[i] ? local[i] : nodes[i].tr;
 
     if(parent<Resources::MAX_NUM_SKELETAL_NODES)
-      tr[i] = tr[parent]*mat; else
-      tr[i] = mt*mat;
+      tr[i] = mulMatrix(tr[parent],mat); else
+      tr[i] = mulMatrix(mt,mat);
 
     if(i==BIP01_HEAD && (headRotX!=0 || headRotY!=0)) {
       Matrix4x4& m = tr[i];
@@ -455,8 +466,8 @@ void Pose::implMkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent) {
   for(size_t i=0;i<nodes.size();++i){
     if(nodes[i].parent!=parent)
       continue;
-    auto mat = hasSamples[i] ? mkMatrix(base[i]) : nodes[i].tr;
-    tr[i] = mt*mat;
+    auto mat = hasSamples[i] ? mkMatrix(sample(base,i)) : nodes[i].tr;
+    tr[i] = mulMatrix(mt,mat);
     implMkSkeleton(tr[i],i);
     }
   }
@@ -779,7 +790,7 @@ const Tempest::Matrix4x4 Pose::rootNode() const {
   if(skeleton->rootNodes.size())
     id = skeleton->rootNodes[0];
   auto& nodes = skeleton->nodes;
-  return hasSamples[id] ? mkMatrix(base[id]) : nodes[id].tr;
+  return hasSamples[id] ? mkMatrix(sample(base,id)) : nodes[id].tr;
   }
 
 const Matrix4x4 Pose::rootBone() const {
@@ -874,6 +885,28 @@ const Matrix4x4* Pose::transform() const {
   return tr;
   }
 
+zenkit::AnimationSample Pose::sample(const float* s, size_t id) {
+  zenkit::AnimationSample smp;
+  smp.position.x = s[0*MaxBones+id];
+  smp.position.y = s[1*MaxBones+id];
+  smp.position.z = s[2*MaxBones+id];
+  smp.rotation.x = s[3*MaxBones+id];
+  smp.rotation.y = s[4*MaxBones+id];
+  smp.rotation.z = s[5*MaxBones+id];
+  smp.rotation.w = s[6*MaxBones+id];
+  return smp;
+  }
+
+void Pose::setSample(float* s, size_t id, const zenkit::AnimationSample& smp) {
+  s[0*MaxBones+id] = smp.position.x;
+  s[1*MaxBones+id] = smp.position.y;
+  s[2*MaxBones+id] = smp.position.z;
+  s[3*MaxBones+id] = smp.rotation.x;
+  s[4*MaxBones+id] = smp.rotation.y;
+  s[5*MaxBones+id] = smp.rotation.z;
+  s[6*MaxBones+id] = smp.rotation.w;
+  }
+
 Vec3 Pose::mkBaseTranslation() {
   if(numBones==0)
     return Vec3();
@@ -8,6 +8,7 @@
 #include "game/constants.h"
 #include "animation.h"
 #include "resources.h"
+#include "animmath.h"
 
 class Skeleton;
 class Serialize;
@@ -97,6 +98,11 @@ class Pose final {
       S_Valid = 2,
       };
 
+    enum : size_t {
+      MaxBones = Resources::MAX_NUM_SKELETAL_NODES,
+      };
+    static_assert(MaxBones%4==0);
+
     struct Layer final {
       const Animation::Sequence* seq      = nullptr;
       uint64_t                   sAnim    = 0;
@@ -113,6 +119,8 @@ class Pose final {
       void     setBreak()      { bits |=0x8000; }
       };
 
+    static auto sample(const float* s, size_t id) -> zenkit::AnimationSample;
+    static void setSample(float* s, size_t id, const zenkit::AnimationSample& smp);
     auto mkBaseTranslation() -> Tempest::Vec3;
     void mkSkeleton(const Tempest::Matrix4x4 &mt);
     void implMkSkeleton(const Tempest::Matrix4x4 &mt);
@@ -148,9 +156,9 @@ class Pose final {
     float                           headRotX = 0, headRotY = 0;
 
     size_t                          numBones = 0;
-    SampleStatus                    hasSamples[Resources::MAX_NUM_SKELETAL_NODES] = {};
-    zenkit::AnimationSample         base      [Resources::MAX_NUM_SKELETAL_NODES] = {};
-    zenkit::AnimationSample         prev      [Resources::MAX_NUM_SKELETAL_NODES] = {};
-    Tempest::Matrix4x4              tr        [Resources::MAX_NUM_SKELETAL_NODES] = {};
+    SampleStatus                    hasSamples[MaxBones] = {};
+    float                           base      [SamplePlanes*MaxBones] = {}; // SoA, see animmath.h
+    float                           prev      [SamplePlanes*MaxBones] = {};
+    Tempest::Matrix4x4              tr        [MaxBones] = {};
     Tempest::Matrix4x4              pos;
   };
@@ -390,10 +390,16 @@ void PackedMesh::Meshlet::merge(const Meshlet& other) {
   vertSz = uint8_t(vertSz+other.vertSz);
   }
 
-PackedMesh::PackedMesh(const zenkit::Mesh& mesh, PkgType type) {
+PackedMesh::PackedMesh(const zenkit::Mesh& mesh, PkgType type, std::string_view cacheName) {
   if(type==PK_VisualLnd || type==PK_Visual) {
+    if(loadCache(cacheName,type,mesh.materials.size())) {
+      for(auto& i:subMeshes)
+        i.material = mesh.materials[i.materialId];
+      return;
+      }
     packMeshletsLnd(mesh);
     computeBbox();
+    saveCache(cacheName,type);
     return;
     }
 
@@ -403,7 +409,13 @@ PackedMesh::PackedMesh(const zenkit::Mesh& mesh, PkgType type) {
     }
   }
 
-PackedMesh::PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type) {
+PackedMesh::PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type, std::string_view cacheName) {
+  if(loadCache(cacheName,type,mesh.sub_meshes.size())) {
+    for(auto& i:subMeshes)
+      i.material = mesh.sub_meshes[i.materialId].mat;
+    return;
+    }
+
   subMeshes.resize(mesh.sub_meshes.size());
   isUsingAlphaTest = mesh.alpha_test;
   {
@@ -413,6 +425,7 @@ PackedMesh::PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type) {
   }
 
   packMeshletsObj(mesh,type,nullptr);
+  saveCache(cacheName,type);
   }
 
 PackedMesh::PackedMesh(const zenkit::SoftSkinMesh& skinned) {
@@ -580,7 +593,8 @@ void PackedMesh::packMeshletsLnd(const zenkit::Mesh& mesh) {
       meshlets[i].updateBounds(mesh);
 
     SubMesh pack;
-    pack.material  = mesh.materials[mId];
+    pack.material   = mesh.materials[mId];
+    pack.materialId = mId;
     pack.iboOffset = indices.size();
     for(auto& i:meshlets)
       i.flush(vertices,indices,indices8,meshletBounds,mesh);
@@ -605,8 +619,9 @@ void PackedMesh::packMeshletsObj(const zenkit::MultiResolutionMesh& mesh, PkgTyp
 
   for(size_t mId=0; mId<mesh.sub_meshes.size(); ++mId) {
     auto& sm      = mesh.sub_meshes[mId];
-    auto& pack    = subMeshes[mId];
-    pack.material = sm.mat;
+    auto& pack      = subMeshes[mId];
+    pack.material   = sm.mat;
+    pack.materialId = uint32_t(mId);
 
     heap.clear();
     for(size_t i=0; i<sm.triangles.size(); ++i) {
@@ -765,6 +780,75 @@ void PackedMesh::computeBbox() {
     }
   }
 
+bool PackedMesh::loadCache(std::string_view name, PkgType type, size_t matCount) {
+  AssetCache::Reader rd;
+  if(name.empty() || !Resources::assetCache().load(AssetCache::K_Mesh,name,rd))
+    return false;
+
+  uint8_t  pkType = 0, alphaTest = 0;
+  uint32_t subCount = 0;
+  rd.read(pkType);
+  rd.read(alphaTest);
+  rd.read(mBbox[0]);
+  rd.read(mBbox[1]);
+  rd.read(vertices);
+  rd.read(verticesA);
+  rd.read(indices);
+  rd.read(indices8);
+  rd.read(verticesId);
+  rd.read(meshletBounds);
+  rd.read(subCount);
+  bool valid = rd.isOk() && pkType==type && subCount<=rd.remain();
+  if(valid)
+    subMeshes.resize(subCount);
+  for(auto& i:subMeshes) {
+    uint64_t offset = 0, length = 0;
+    rd.read(i.materialId);
+    rd.read(offset);
+    rd.read(length);
+    i.iboOffset = size_t(offset);
+    i.iboLength = size_t(length);
+    valid &= (i.materialId<matCount && offset+length<=indices.size());
+    }
+
+  if(!valid || !rd.isOk() || rd.remain()!=0) {
+    vertices.clear();
+    verticesA.clear();
+    indices.clear();
+    indices8.clear();
+    verticesId.clear();
+    meshletBounds.clear();
+    subMeshes.clear();
+    return false;
+    }
+  isUsingAlphaTest = (alphaTest!=0);
+  return true;
+  }
+
+void PackedMesh::saveCache(std::string_view name, PkgType type) const {
+  if(name.empty() || !Resources::assetCache().isEnabled())
+    return;
+
+  AssetCache::Writer wr;
+  wr.write(uint8_t(type));
+  wr.write(uint8_t(isUsingAlphaTest ? 1 : 0));
+  wr.write(mBbox[0]);
+  wr.write(mBbox[1]);
+  wr.write(vertices);
+  wr.write(verticesA);
+  wr.write(indices);
+  wr.write(indices8);
+  wr.write(verticesId);
+  wr.write(meshletBounds);
+  wr.write(uint32_t(subMeshes.size()));
+  for(auto& i:subMeshes) {
+    wr.write(i.materialId);
+    wr.write(uint64_t(i.iboOffset));
+    wr.write(uint64_t(i.iboLength));
+    }
+  Resources::assetCache().save(AssetCache::K_Mesh,name,wr);
+  }
+
 void PackedMesh::dbgUtilization(const std::vector<Meshlet>& meshlets) {
   size_t usedV = 0, allocatedV = 0;
   size_t usedP = 0, allocatedP = 0;
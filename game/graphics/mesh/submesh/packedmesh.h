@@ -33,6 +33,7 @@ class PackedMesh {
 
     struct SubMesh final {
       zenkit::Material material;
+      uint32_t         materialId = 0; // index in source mesh
       size_t           iboOffset = 0;
       size_t           iboLength = 0;
       };
@@ -53,8 +54,8 @@ class PackedMesh {
     std::vector<uint32_t> verticesId; // only for morph meshes
     bool                  isUsingAlphaTest = true;
 
-    PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type);
-    PackedMesh(const zenkit::Mesh& mesh, PkgType type);
+    PackedMesh(const zenkit::MultiResolutionMesh& mesh, PkgType type, std::string_view cacheName = {});
+    PackedMesh(const zenkit::Mesh& mesh, PkgType type, std::string_view cacheName = {});
     PackedMesh(const zenkit::SoftSkinMesh& mesh);
 
     void debug(std::ostream &out) const;
@@ -118,6 +119,9 @@ class PackedMesh {
 
     void   computeBbox();
 
+    bool   loadCache(std::string_view name, PkgType type, size_t matCount);
+    void   saveCache(std::string_view name, PkgType type) const;
+
     void   dbgUtilization(const std::vector<Meshlet>& meshlets);
     void   dbgMeshlets(const zenkit::Mesh& mesh, const std::vector<Meshlet*>& meshlets);
   };
@@ -55,6 +55,7 @@ class MeshObjects final {
         void   setObjMatrix(const Tempest::Matrix4x4& mt);
         void   setSkeleton (const Skeleton* sk);
         void   setPose     (const Tempest::Matrix4x4& obj, const Pose& p);
+        void   setPose     (const Tempest::Matrix4x4& obj, const Tempest::Matrix4x4* tr);
         void   setAsGhost  (bool g);
         void   setFatness  (float f);
         void   setWind     (zenkit::AnimationType m, float intensity);
@@ -6,6 +6,7 @@
 #include "game/serialize.h"
 #include "graphics/mesh/pose.h"
 #include "graphics/mesh/skeleton.h"
+#include "graphics/rendersnapshot.h"
 #include "utils/fileext.h"
 #include "gothic.h"
 
@@ -272,6 +273,19 @@ bool ObjVisual::updateAnimation(Npc* npc, World& world, uint64_t dt) {
   return false;
   }
 
+void ObjVisual::snapshot(RenderSnapshot& dst, void* owner) const {
+  // only skeletal mobsi are moving between logic steps
+  if(type==M_Mdl) {
+    auto& pose = mdl.view.pose();
+    dst.push(owner,RenderSnapshot::T_Mobsi,mdl.view.transform(),pose.transform(),pose.boneCount());
+    }
+  }
+
+void ObjVisual::setRenderPose(const Tempest::Matrix4x4* tr, size_t count) {
+  if(type==M_Mdl)
+    mdl.view.setRenderPose(tr,count);
+  }
+
 void ObjVisual::processLayers(World& world) {
   if(type==M_Mdl) {
     mdl.view.processLayers(world);
@@ -7,6 +7,7 @@
 
 class Npc;
 class World;
+class RenderSnapshot;
 
 class ObjVisual {
   public:
@@ -30,6 +31,8 @@ class ObjVisual {
     bool updateAnimation(Npc* npc, World& world, uint64_t dt);
     void processLayers(World& world);
     void syncPhysics();
+    void snapshot(RenderSnapshot& dst, void* owner) const;
+    void setRenderPose(const Tempest::Matrix4x4* tr, size_t count);
 
     const ProtoMesh* protoMesh() const;
     const Tempest::Matrix4x4& bone(size_t i) const;
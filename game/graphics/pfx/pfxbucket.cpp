@@ -6,9 +6,13 @@
 #include "particlefx.h"
 
 #include "world/objects/npc.h"
+#include "utils/fnv.h"
 
 using namespace Tempest;
 
+// particles per simulation job; multiple of 4
+static constexpr size_t SimChunk = 1024;
+
 static uint64_t ppsDiff(const ParticleFx& decl, bool loop, uint64_t time0, uint64_t time1) {
   if(time1<=time0)
     return 0;
@@ -24,11 +28,25 @@ static uint64_t ppsDiff(const ParticleFx& decl, bool loop, uint64_t time0, uint6
   return emitted1-emitted0;
   }
 
-float PfxBucket::ParState::lifeTime() const {
-  return 1.f-life/float(maxLife);
+void PfxBucket::ParState::resize(size_t sz) {
+  life   .resize(sz,0.f);
+  maxLife.resize(sz,1.f);
+  for(auto v:{&posX,&posY,&posZ,&dirX,&dirY,&dirZ})
+    v->resize(sz,0.f);
+  trail.resize(sz);
   }
 
-std::mt19937 PfxBucket::rndEngine;
+void PfxBucket::ParState::clear(size_t i) {
+  life   [i] = 0;
+  maxLife[i] = 1;
+  posX[i] = 0;
+  posY[i] = 0;
+  posZ[i] = 0;
+  dirX[i] = 0;
+  dirY[i] = 0;
+  dirZ[i] = 0;
+  trail[i].clear();
+  }
 
 void PfxBucket::Draw::setPfxData(const Tempest::StorageBuffer& ssbo) {
   if(ssbo.isEmpty())
@@ -95,8 +113,27 @@ PfxBucket::PfxBucket(const ParticleFx &decl, PfxObjects& parent, const SceneGlob
   uint64_t pps     = uint64_t(std::ceil(decl.maxPps()));
   uint64_t reserve = (lt*pps+1000-1)/1000;
   blockSize        = size_t(reserve);
-  if(blockSize==0)
-    blockSize=1;
+  // padded for 4-wide kernels
+  blockSize        = std::max<size_t>((blockSize+3)/4*4, 4);
+
+  lerp.colorS[0]   = decl.visTexColorStart.x;
+  lerp.colorS[1]   = decl.visTexColorStart.y;
+  lerp.colorS[2]   = decl.visTexColorStart.z;
+  lerp.colorE[0]   = decl.visTexColorEnd.x;
+  lerp.colorE[1]   = decl.visTexColorEnd.y;
+  lerp.colorE[2]   = decl.visTexColorEnd.z;
+  lerp.alphaS      = decl.visAlphaStart;
+  lerp.alphaE      = decl.visAlphaEnd;
+  lerp.sizeX       = decl.visSizeStart.x;
+  lerp.sizeY       = decl.visSizeStart.y;
+  lerp.sizeEScale  = decl.visSizeEndScale;
+
+  // emitters of the same effect get distinct, but reproducible random streams
+  seed             = Fnv::hash(decl.dbgName.data(),decl.dbgName.size());
+
+  // rough extent of the effect, for importance estimate
+  radius           = decl.shpDim.length()*0.5f + decl.shpOffsetVec.length() +
+                     std::abs(decl.velAvg)*decl.lspPartAvg + std::max(decl.visSizeStart.x,decl.visSizeStart.y);
 
   auto& device = Resources::device();
   for(size_t i=0; i<Resources::MaxFramesInFlight; ++i) {
@@ -164,6 +201,7 @@ size_t PfxBucket::allocBlock() {
     if(!block[i].allocated) {
       block[i].allocated = true;
       block[i].timeTotal = 0;
+      block[i].simulated = false;
       return i;
       }
     }
@@ -179,7 +217,7 @@ size_t PfxBucket::allocBlock() {
   pfxCpu   .resize(particles.size());
 
   for(size_t i=0; i<blockSize; ++i)
-    particles[b.offset+i].life = 0;
+    particles.life[b.offset+i] = 0;
   return block.size()-1;
   }
 
@@ -212,7 +250,11 @@ size_t PfxBucket::allocEmitter() {
   for(size_t i=0; i<impl.size(); ++i) {
     auto& b = impl[i];
     if(b.st==S_Free) {
-      b.st = S_Inactive;
+      b.st        = S_Inactive;
+      b.ambient   = false;
+      b.emitScale = 1;
+      b.emitFrac  = 0;
+      b.rng       = PfxRandom(seed,emitterSeq++);
       return i;
       }
     }
@@ -220,6 +262,7 @@ size_t PfxBucket::allocEmitter() {
   auto& e = impl.back();
   e.block = size_t(-1); // no backup memory
   e.st    = S_Inactive;
+  e.rng   = PfxRandom(seed,emitterSeq++);
   for(size_t i=0; i<Resources::MaxFramesInFlight; ++i)
     forceUpdate[i] = true;
 
@@ -264,77 +307,77 @@ bool PfxBucket::shrink() {
   return false;
   }
 
-float PfxBucket::randf() {
-  return float(rndEngine()%10000)/10000.f;
+float PfxBucket::randf(PfxRandom& rng) {
+  return rng.randf();
   }
 
-float PfxBucket::randf(float base, float var) {
-  return (2.f*randf()-1.f)*var + base;
+float PfxBucket::randf(PfxRandom& rng, float base, float var) {
+  return (2.f*randf(rng)-1.f)*var + base;
   }
 
 void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t particle) {
-  auto& p   = particles[particle];
-
-  p.life    = uint16_t(randf(decl.lspPartAvg,decl.lspPartVar));
-  p.maxLife = p.life;
+  auto&          rng  = emitter.rng;
+  const uint16_t life = uint16_t(randf(rng,decl.lspPartAvg,decl.lspPartVar));
+  Vec3           pos  = {};
+  Vec3           dir  = {};
 
   // TODO: pfx.shpDistribType, pfx.shpDistribWalkSpeed;
   switch(decl.shpType) {
     case ParticleFx::EmitterType::Point:{
-      p.pos = Vec3();
+      pos = Vec3();
       break;
       }
     case ParticleFx::EmitterType::Line:{
-      float at = randf();
-      p.pos = Vec3(at,at,at);
+      float at = randf(rng);
+      pos = Vec3(at,at,at);
       break;
       }
     case ParticleFx::EmitterType::Box:{
+      // NOTE: argument evaluation order is unspecified, keep rng calls sequenced
+      const float x = randf(rng)*2.f-1.f;
+      const float y = randf(rng)*2.f-1.f;
+      const float z = randf(rng)*2.f-1.f;
       if(decl.shpIsVolume) {
-        p.pos = Vec3(randf()*2.f-1.f,
-                     randf()*2.f-1.f,
-                     randf()*2.f-1.f);
-        p.pos*=0.5;
+        pos = Vec3(x,y,z);
+        pos*=0.5;
         } else {
         // TODO
-        p.pos = Vec3(randf()*2.f-1.f,
-                     randf()*2.f-1.f,
-                     randf()*2.f-1.f);
-        p.pos*=0.5;
+        pos = Vec3(x,y,z);
+        pos*=0.5;
         }
       break;
       }
     case ParticleFx::EmitterType::Sphere:{
-      float theta = float(2.0*M_PI)*randf();
-      float phi   = std::acos(1.f - 2.f * randf());
-      p.pos = Vec3(std::sin(phi) * std::cos(theta),
-                   std::sin(phi) * std::sin(theta),
-                   std::cos(phi));
-      //p.pos*=0.5;
+      float theta = float(2.0*M_PI)*randf(rng);
+      float phi   = std::acos(1.f - 2.f * randf(rng));
+      pos = Vec3(std::sin(phi) * std::cos(theta),
+                 std::sin(phi) * std::sin(theta),
+                 std::cos(phi));
+      //pos*=0.5;
       if(decl.shpIsVolume)
-        p.pos*=randf();
+        pos*=randf(rng);
       break;
       }
     case ParticleFx::EmitterType::Circle:{
-      float a = float(2.0*M_PI)*randf();
-      p.pos = Vec3(std::sin(a),
-                   0,
-                   std::cos(a));
-      //p.pos*=0.5;
+      float a = float(2.0*M_PI)*randf(rng);
+      pos = Vec3(std::sin(a),
+                 0,
+                 std::cos(a));
+      //pos*=0.5;
       if(decl.shpIsVolume)
-        p.pos = p.pos*std::sqrt(randf());
+        pos = pos*std::sqrt(randf(rng));
       break;
       }
     case ParticleFx::EmitterType::Mesh:{
-      p.pos = Vec3();
+      pos = Vec3();
       auto mesh = (emitter.mesh!=nullptr) ? emitter.mesh : decl.shpMesh;
       auto pose = (emitter.mesh!=nullptr) ? emitter.pose : nullptr;
       if(mesh!=nullptr) {
-        auto pos = mesh->randCoord(randf(),pose);
-        pos -= emitter.pos;
-        p.pos = emitter.direction[0]*pos.x +
-                emitter.direction[1]*pos.y +
-                emitter.direction[2]*pos.z;
+        auto at = mesh->randCoord(randf(rng),pose);
+        at -= emitter.pos;
+        pos = emitter.direction[0]*at.x +
+              emitter.direction[1]*at.y +
+              emitter.direction[2]*at.z;
         }
       break;
       }
@@ -343,34 +386,34 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
   if(decl.shpType!=ParticleFx::EmitterType::Point &&
      decl.shpType!=ParticleFx::EmitterType::Mesh) {
     Vec3 dim = decl.shpDim*decl.shpScale(block.timeTotal);
-    p.pos.x*=dim.x;
-    p.pos.y*=dim.y;
-    p.pos.z*=dim.z;
+    pos.x*=dim.x;
+    pos.y*=dim.y;
+    pos.z*=dim.z;
     }
 
   switch(decl.shpFOR) {
     case ParticleFx::Frame::Object:
     case ParticleFx::Frame::Node: {
-      p.pos += emitter.direction[0]*decl.shpOffsetVec.x +
-               emitter.direction[1]*decl.shpOffsetVec.y +
-               emitter.direction[2]*decl.shpOffsetVec.z;
+      pos += emitter.direction[0]*decl.shpOffsetVec.x +
+             emitter.direction[1]*decl.shpOffsetVec.y +
+             emitter.direction[2]*decl.shpOffsetVec.z;
       break;
       }
     case ParticleFx::Frame::World: {
-      p.pos += decl.shpOffsetVec;
+      pos += decl.shpOffsetVec;
       break;
       }
     }
 
   switch(decl.dirMode) {
     case ParticleFx::Dir::Rand: {
-      float dy    = 1.f - 2.f * randf();
+      float dy    = 1.f - 2.f * randf(rng);
       float sn    = std::sqrt(1-dy*dy);
-      float theta = float(2.0*M_PI)*randf();
+      float theta = float(2.0*M_PI)*randf(rng);
       float dx    = sn * std::cos(theta);
       float dz    = sn * std::sin(theta);
 
-      p.dir       = Vec3(dx,dy,dz);
+      dir         = Vec3(dx,dy,dz);
       break;
       }
     case ParticleFx::Dir::Dir: {
@@ -383,8 +426,8 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
       if(decl.dirAngleElevVar>=180 )
         dirAngleElevVar = 0;
 
-      float head = (90+randf(decl.dirAngleHead,dirAngleHeadVar))*float(M_PI)/180.f;
-      float elev = (   randf(decl.dirAngleElev,dirAngleElevVar))*float(M_PI)/180.f;
+      float head = (90+randf(rng,decl.dirAngleHead,dirAngleHeadVar))*float(M_PI)/180.f;
+      float elev = (   randf(rng,decl.dirAngleElev,dirAngleElevVar))*float(M_PI)/180.f;
 
       float dx = std::cos(elev) * std::cos(head);
       float dy = std::sin(elev);
@@ -393,13 +436,13 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
       switch(decl.dirFOR) {
         case ParticleFx::Frame::Object:
         case ParticleFx::Frame::Node: {
-          p.dir = emitter.direction[0]*dx +
-                  emitter.direction[1]*dy +
-                  emitter.direction[2]*dz;
+          dir = emitter.direction[0]*dx +
+                emitter.direction[1]*dy +
+                emitter.direction[2]*dz;
           break;
           }
         case ParticleFx::Frame::World: {
-          p.dir = Vec3(dx,dy,dz);
+          dir = Vec3(dx,dy,dz);
           break;
           }
         }
@@ -424,145 +467,230 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
           break;
           }
         }
-      p.dir += targetPos - (emitter.pos+p.pos);
+      dir += targetPos - (emitter.pos+pos);
       break;
     }
 
   if(!decl.useEmittersFOR)
-    p.pos += emitter.pos;
+    pos += emitter.pos;
 
-  auto l = p.dir.length();
+  auto l = dir.length();
   if(l!=0.f) {
-    float velocity = randf(decl.velAvg,decl.velVar);
-    p.dir = p.dir*velocity/l;
+    float velocity = randf(rng,decl.velAvg,decl.velVar);
+    dir = dir*velocity/l;
     }
-  }
 
-void PfxBucket::finalize(size_t particle) {
-  particles[particle] = {};
-  pfxCpu   [particle] = {};
+  particles.life   [particle] = float(life);
+  particles.maxLife[particle] = float(life);
+  particles.posX[particle] = pos.x;
+  particles.posY[particle] = pos.y;
+  particles.posZ[particle] = pos.z;
+  particles.dirX[particle] = dir.x;
+  particles.dirY[particle] = dir.y;
+  particles.dirZ[particle] = dir.z;
   }
 
-void PfxBucket::tick(Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt) {
-  ParState& ps = particles[particle+sys.offset];
-  if(ps.life==0)
-    return;
-
-  if(ps.life<=dt){
-    ps.life = 0;
-    sys.count--;
-    finalize(particle+sys.offset);
-    return;
-    }
-
-  const float dtF = float(dt);
-
-  // eval particle
-  ps.life  = uint16_t(ps.life-dt);
-  ps.pos  += ps.dir*dtF;
-  ps.dir  += decl.flyGravity*dtF;
-
-  if(maxTrlTime!=0)
-    tickTrail(ps,emitter,dt);
+void PfxBucket::finalize(size_t particle) {
+  particles.clear(particle);
+  pfxCpu[particle] = {};
   }
 
-void PfxBucket::tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt) {
-  for(auto& i:ps.trail)
+void PfxBucket::tickTrail(size_t particle, const ImplEmitter& emitter, uint64_t dt) {
+  auto& trail = particles.trail[particle];
+  for(auto& i:trail)
     i.time+=dt;
 
   Trail tx;
   if(decl.useEmittersFOR)
-    tx.pos = ps.pos + emitter.pos; else
-    tx.pos = ps.pos;
+    tx.pos = particles.pos(particle) + emitter.pos; else
+    tx.pos = particles.pos(particle);
 
-  if(ps.trail.size()==0) {
-    ps.trail.push_back(tx);
+  if(trail.size()==0) {
+    trail.push_back(tx);
     }
-  else if(ps.trail.back().pos!=tx.pos) {
+  else if(trail.back().pos!=tx.pos) {
     bool extrude = false;
-    if(false && ps.trail.size()>1) {
-      auto u = tx.pos              - ps.trail[ps.trail.size()-2].pos;
-      auto v = ps.trail.back().pos - ps.trail[ps.trail.size()-2].pos;
+    if(false && trail.size()>1) {
+      auto u = tx.pos           - trail[trail.size()-2].pos;
+      auto v = trail.back().pos - trail[trail.size()-2].pos;
       if(std::abs(Vec3::dotProduct(u,v)-u.length()*v.length()) < 0.001f)
         extrude = true;
       }
     if(extrude)
-      ps.trail.back() = tx; else
-      ps.trail.push_back(tx);
+      trail.back() = tx; else
+      trail.push_back(tx);
     }
   else {
-    ps.trail.back().time = 0;
+    trail.back().time = 0;
     }
 
-  for(size_t rm=0; rm<=ps.trail.size(); ++rm) {
-    if(rm==ps.trail.size() || ps.trail[rm].time<maxTrlTime) {
-      ps.trail.erase(ps.trail.begin(),ps.trail.begin()+int(rm));
+  for(size_t rm=0; rm<=trail.size(); ++rm) {
+    if(rm==trail.size() || trail[rm].time<maxTrlTime) {
+      trail.erase(trail.begin(),trail.begin()+int(rm));
       break;
       }
     }
   }
 
-void PfxBucket::tick(uint64_t dt, const Vec3& viewPos) {
-  if(decl.isDecal()) {
-    implTickDecals(dt,viewPos);
+void PfxBucket::tickPrepare(uint64_t dt, PfxObjects::Budget& budget, std::vector<SimJob>& jobs) {
+  if(decl.isDecal())
     return;
-    }
-  implTickCommon(dt,viewPos);
-  }
 
-void PfxBucket::implTickCommon(uint64_t dt, const Vec3& viewPos) {
-  bool doShrink = false;
-  for(auto& emitter:impl) {
-    if(emitter.st==S_Free)
+  for(size_t id=0; id<impl.size(); ++id) {
+    if(impl[id].st==S_Free)
       continue;
 
-    const auto dp     = emitter.pos-viewPos;
-    const bool nearby = (dp.quadLength()<PfxObjects::viewRage*PfxObjects::viewRage);
-
-    if(emitter.next==nullptr && decl.ppsCreateEm!=nullptr && emitter.waitforNext<dt && emitter.st==S_Active) {
-      emitter.next.reset(new PfxEmitter(parent,decl.ppsCreateEm));
-      auto& e = *emitter.next;
-      e.setPosition(emitter.pos.x,emitter.pos.y,emitter.pos.z);
-      e.setActive(true);
-      e.setLooped(emitter.isLoop);
+    if(impl[id].next==nullptr && decl.ppsCreateEm!=nullptr && impl[id].waitforNext<dt && impl[id].st==S_Active) {
+      auto  next    = std::make_unique<PfxEmitter>(parent,decl.ppsCreateEm);
+      auto& emitter = impl[id]; // ppsCreateEm may allocate in this bucket
+      next->setPosition(emitter.pos.x,emitter.pos.y,emitter.pos.z);
+      next->setActive(true);
+      next->setLooped(emitter.isLoop);
+      emitter.next = std::move(next);
       }
 
+    auto& emitter = impl[id];
     if(emitter.waitforNext>=dt)
       emitter.waitforNext-=dt;
 
+    if(emitter.st==S_Active) {
+      const float w = importance(emitter,budget);
+      emitter.emitScale = (w<budget.cutoff) ? 0.f : 1.f-budget.cutoff*(1.f-w);
+      budget.stat.emitters++;
+      if(emitter.emitScale==0)
+        budget.stat.culled++;
+      }
+
+    if(emitter.block==size_t(-1))
+      continue;
+
+    auto& p = block[emitter.block];
+    p.simulated = (p.count>0);
+    if(!p.simulated)
+      continue;
+
+    for(size_t i=0; i<blockSize; i+=SimChunk) {
+      SimJob job;
+      job.owner   = this;
+      job.emitter = id;
+      job.begin   = p.offset+i;
+      job.end     = p.offset+std::min(i+SimChunk,blockSize);
+      jobs.push_back(job);
+      }
+    }
+  }
+
+void PfxBucket::simulate(SimJob& job, uint64_t dt) {
+  const auto& emitter    = impl[job.emitter];
+  const auto& p          = block[emitter.block];
+  const float dtF        = float(dt);
+  const float gravity[3] = {decl.flyGravity.x, decl.flyGravity.y, decl.flyGravity.z};
+
+  for(size_t i=job.begin; i<job.end; i+=4) {
+    float* const pos[3] = {&particles.posX[i], &particles.posY[i], &particles.posZ[i]};
+    float* const dir[3] = {&particles.dirX[i], &particles.dirY[i], &particles.dirZ[i]};
+
+    const uint32_t died = pfxIntegrate(&particles.life[i],pos,dir,dtF,gravity);
+    for(size_t l=0; l<4; ++l) {
+      if(died & (1u << l)) {
+        finalize(i+l);
+        job.died++;
+        }
+      else if(maxTrlTime!=0 && particles.life[i+l]>0) {
+        tickTrail(i+l,emitter,dt);
+        }
+      }
+    buildGroup(p,i);
+    }
+  }
+
+void PfxBucket::commit(const SimJob& job) {
+  auto& p = block[impl[job.emitter].block];
+  p.count -= job.died;
+  }
+
+float PfxBucket::importance(const ImplEmitter& emitter, const PfxObjects::Budget& budget) const {
+  const float dist  = (emitter.pos-budget.viewPos).length();
+  const float fDist = 1.f - std::min(dist/PfxObjects::viewRage, 1.f);
+  // ~0.1 radian of view is considered as large
+  const float fSize = std::min(10.f*radius/std::max(dist,1.f), 1.f);
+  const float fCat  = emitter.ambient ? 0.5f : 1.f;
+  const float fVis  = budget.frustrum->testPoint(emitter.pos,radius) ? 1.f : 0.25f;
+  return fCat*fVis*(fDist+fSize)*0.5f;
+  }
+
+void PfxBucket::tickSchedule(uint64_t dt, PfxObjects::Budget& budget, std::vector<SimJob>& jobs) {
+  if(decl.isDecal()) {
+    implTickDecals(dt);
+    return;
+    }
+
+  bool doShrink = false;
+  for(size_t id=0; id<impl.size(); ++id) {
+    auto& emitter = impl[id];
+    if(emitter.st==S_Free)
+      continue;
+
+    const auto dp     = emitter.pos-budget.viewPos;
+    const bool nearby = (dp.quadLength()<PfxObjects::viewRage*PfxObjects::viewRage) && emitter.emitScale>0;
+
     if(emitter.block!=size_t(-1)) {
       auto& p = getBlock(emitter);
-      if(p.count>0) {
-        for(size_t i=0;i<blockSize;++i)
-          tick(p,emitter,i,dt);
-        if(p.count==0 && (emitter.st==S_Fade || !nearby)) {
-          // free mem
-          freeBlock(emitter.block);
-          if(emitter.st==S_Fade)
-            emitter.st = S_Free;
-          doShrink = true;
-          continue;
-          }
+      if(p.simulated && p.count==0 && (emitter.st==S_Fade || !nearby)) {
+        // free mem
+        freeBlock(emitter.block);
+        if(emitter.st==S_Fade)
+          emitter.st = S_Free;
+        doShrink = true;
+        continue;
         }
+      p.simulated = false;
       }
 
     if(emitter.st==S_Active && nearby) {
-      auto& p = getBlock(emitter);
-      auto dE = ppsDiff(decl,emitter.isLoop,p.timeTotal,p.timeTotal+dt);
-      tickEmit(p,emitter,dE);
-      }
+      auto& p  = getBlock(emitter);
+      auto  dE = ppsDiff(decl,emitter.isLoop,p.timeTotal,p.timeTotal+dt);
+      // throttled emitters carry fractional particles to the next tick
+      float fE = float(dE)*emitter.emitScale + emitter.emitFrac;
+      dE               = uint64_t(fE);
+      emitter.emitFrac = fE-float(dE);
+      dE               = std::min<uint64_t>(dE,budget.left);
+      budget.left     -= size_t(dE);
+      if(dE==0)
+        continue;
 
-    if(emitter.block!=size_t(-1)) {
-      auto& p = getBlock(emitter);
-      p.timeTotal+=dt;
+      SimJob job;
+      job.owner   = this;
+      job.emitter = id;
+      job.emit    = dE;
+      jobs.push_back(job);
       }
     }
 
+  // only trailing free emitters/blocks are released, so indices in jobs stay valid
   if(doShrink)
     shrink();
   }
 
-void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
+void PfxBucket::emit(SimJob& job) {
+  auto& emitter = impl[job.emitter];
+  tickEmit(block[emitter.block],emitter,job.emit);
+  }
+
+void PfxBucket::tickFinalize(uint64_t dt, PfxObjects::Budget& budget) {
+  if(!decl.isDecal()) {
+    for(auto& emitter:impl) {
+      if(emitter.st==S_Free || emitter.block==size_t(-1))
+        continue;
+      auto& p = block[emitter.block];
+      p.timeTotal += dt;
+      budget.stat.particles += p.count;
+      }
+    }
+  buildSsboTrails();
+  }
+
+void PfxBucket::implTickDecals(uint64_t) {
   for(auto& emitter:impl) {
     if(emitter.st==S_Free)
       continue;
@@ -574,26 +702,35 @@ void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
       } else
     if(emitter.st==S_Fade) {
       for(size_t i=0; i<blockSize; ++i)
-        particles[p.offset+i].life = 0;
+        particles.life[p.offset+i] = 0;
       p.count = 0;
       freeBlock(emitter.block);
       emitter.st = S_Free;
       }
     }
+
+  // decals are not simulated, but emitter may move
+  for(auto& p:block) {
+    if(p.count==0)
+      continue;
+    for(size_t i=0; i<blockSize; i+=4)
+      buildGroup(p,p.offset+i);
+    }
   }
 
 void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited) {
   size_t lastI = 0;
   for(size_t id=1; emited>0; ++id) {
     const size_t i  = id%blockSize;
-    ParState&    ps = particles[i+p.offset];
-    if(ps.life==0) { // free slot
+    const size_t pi = i+p.offset;
+    if(particles.life[pi]==0) { // free slot
       --emited;
       lastI = i;
-      init(p,emitter,i+p.offset);
-      if(ps.life==0)
+      init(p,emitter,pi);
+      if(particles.life[pi]==0)
         continue;
       p.count++;
+      buildGroup(p,pi-pi%4);
       } else {
       // out of slots
       if(lastI==i)
@@ -602,61 +739,44 @@ void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited) {
     }
   }
 
-void PfxBucket::buildSsbo() {
-  buildSsboTrails();
-
-  auto  colorS          = decl.visTexColorStart;
-  auto  colorE          = decl.visTexColorEnd;
-  auto  visSizeStart    = decl.visSizeStart;
-  auto  visSizeEndScale = decl.visSizeEndScale;
-  auto  visAlphaStart   = decl.visAlphaStart;
-  auto  visAlphaEnd     = decl.visAlphaEnd;
-  auto  visAlphaFunc    = decl.visMaterial.alpha;
+void PfxBucket::buildGroup(const Block& p, size_t at) {
+  float cl[PfxLerpCount][4];
+  pfxLerp(&particles.life[at],&particles.maxLife[at],lerp,cl);
 
-  for(auto& p:block) {
-    if(p.count==0)
+  const bool additive = (decl.visMaterial.alpha==Material::AlphaFunc::AdditiveLight);
+  for(size_t l=0; l<4; ++l) {
+    auto& px = pfxCpu[at+l];
+    if(particles.life[at+l]==0) {
+      px.size = Vec3();
       continue;
+      }
 
-    for(size_t pId=0; pId<blockSize; ++pId) {
-      ParState& ps = particles[pId+p.offset];
-      auto&     px = pfxCpu   [pId+p.offset];
-
-      if(ps.life==0) {
-        px.size = Vec3();
-        continue;
-        }
-
-      const float a     = ps.lifeTime();
-      const Vec3  cl    = colorS*(1.f-a)        + colorE*a;
-      const float clA   = visAlphaStart*(1.f-a) + visAlphaEnd*a;
-
-      const float scale = 1.f*(1.f-a) + a*visSizeEndScale;
-      const float szX   = visSizeStart.x*scale;
-      const float szY   = visSizeStart.y*scale;
-      const float szZ   = 0.1f*((szX+szY)*0.5f);
-
-      struct Color {
-        uint8_t r=255;
-        uint8_t g=255;
-        uint8_t b=255;
-        uint8_t a=255;
-        } color;
-
-      if(visAlphaFunc==Material::AlphaFunc::AdditiveLight) {
-        color.r = uint8_t(cl.x*clA);
-        color.g = uint8_t(cl.y*clA);
-        color.b = uint8_t(cl.z*clA);
-        color.a = uint8_t(255);
-        } else {
-        color.r = uint8_t(cl.x);
-        color.g = uint8_t(cl.y);
-        color.b = uint8_t(cl.z);
-        color.a = uint8_t(clA*255);
-        }
-      uint32_t colorU32;
-      std::memcpy(&colorU32,&color,4);
-      buildBilboard(px,p,ps, colorU32, szX,szY,szZ);
+    const float clA = cl[PfxLerpA  ][l];
+    const float szX = cl[PfxLerpSzX][l];
+    const float szY = cl[PfxLerpSzY][l];
+    const float szZ = 0.1f*((szX+szY)*0.5f);
+
+    struct Color {
+      uint8_t r=255;
+      uint8_t g=255;
+      uint8_t b=255;
+      uint8_t a=255;
+      } color;
+
+    if(additive) {
+      color.r = uint8_t(cl[PfxLerpR][l]*clA);
+      color.g = uint8_t(cl[PfxLerpG][l]*clA);
+      color.b = uint8_t(cl[PfxLerpB][l]*clA);
+      color.a = uint8_t(255);
+      } else {
+      color.r = uint8_t(cl[PfxLerpR][l]);
+      color.g = uint8_t(cl[PfxLerpG][l]);
+      color.b = uint8_t(cl[PfxLerpB][l]);
+      color.a = uint8_t(clA*255);
       }
+    uint32_t colorU32;
+    std::memcpy(&colorU32,&color,4);
+    buildBilboard(px,p,at+l, colorU32, szX,szY,szZ);
     }
   }
 
@@ -667,26 +787,27 @@ void PfxBucket::buildSsboTrails() {
   trlCpu.reserve(trlCpu.size());
   trlCpu.clear();
 
-  for(auto& p:particles) {
-    if(p.life==0)
+  for(size_t i=0; i<particles.size(); ++i) {
+    auto& trail = particles.trail[i];
+    if(particles.life[i]==0)
       continue;
-    if(p.trail.size()<2)
+    if(trail.size()<2)
       continue;
 
-    float maxT = float(std::min(maxTrlTime,p.trail[0].time));
-    for(size_t r=1; r<p.trail.size(); ++r) {
+    float maxT = float(std::min(maxTrlTime,trail[0].time));
+    for(size_t r=1; r<trail.size(); ++r) {
       PfxState st;
-      buildTrailSegment(st,p.trail[r-1],p.trail[r],maxT);
+      buildTrailSegment(st,trail[r-1],trail[r],maxT);
       trlCpu.push_back(st);
       }
     }
   }
 
-void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
+void PfxBucket::buildBilboard(PfxState& v, const Block& p, size_t particle, const uint32_t color,
                               float szX, float szY, float szZ) {
   if(decl.useEmittersFOR)
-    v.pos = ps.pos + p.pos; else
-    v.pos = ps.pos;
+    v.pos = particles.pos(particle) + p.pos; else
+    v.pos = particles.pos(particle);
 
   v.size  = Vec3(szX,szY,szZ);
   v.color = color;
@@ -696,7 +817,7 @@ void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, c
   v.bits0 |= uint32_t(decl.visYawAlign ? 1 : 0) << 2;
   v.bits0 |= uint32_t(0) << 3; // TODO: trails
   v.bits0 |= uint32_t(decl.visOrientation) << 4;
-  v.dir   = ps.dir;
+  v.dir   = particles.dir(particle);
   }
 
 void PfxBucket::buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT) {
@@ -2,9 +2,10 @@
 
 #include <Tempest/VertexBuffer>
 #include <vector>
-#include <random>
 
 #include "graphics/pfx/pfxobjects.h"
+#include "graphics/pfx/pfxmath.h"
+#include "graphics/pfx/pfxrandom.h"
 #include "resources.h"
 
 class ParticleFx;
@@ -34,6 +35,11 @@ class PfxBucket {
 
       const Npc*    targetNpc    = nullptr;
 
+      bool          ambient      = false;
+      float         emitScale    = 1;
+      float         emitFrac     = 0;
+      PfxRandom     rng;
+
       const PfxEmitterMesh* mesh = nullptr;
       const Pose*           pose = nullptr;
 
@@ -50,6 +56,16 @@ class PfxBucket {
       uint32_t      colorB = 0;
       };
 
+    // range of particles within one emitter block, simulated by worker threads
+    struct SimJob final {
+      PfxBucket*    owner   = nullptr;
+      size_t        emitter = 0;
+      size_t        begin   = 0;
+      size_t        end     = 0;
+      size_t        died    = 0;
+      uint64_t      emit    = 0;
+      };
+
     const ParticleFx&           decl;
     PfxObjects&                 parent;
 
@@ -66,8 +82,13 @@ class PfxBucket {
     void                        freeEmitter(size_t& id);
 
     ImplEmitter&                get(size_t id) { return impl[id]; }
-    void                        tick(uint64_t dt, const Tempest::Vec3& viewPos);
-    void                        buildSsbo();
+    // tick phases: tickPrepare, simulate(parallel), commit, tickSchedule, emit(parallel) and tickFinalize
+    void                        tickPrepare (uint64_t dt, PfxObjects::Budget& budget, std::vector<SimJob>& jobs);
+    void                        simulate    (SimJob& job, uint64_t dt);
+    void                        commit      (const SimJob& job);
+    void                        tickSchedule(uint64_t dt, PfxObjects::Budget& budget, std::vector<SimJob>& jobs);
+    void                        emit        (SimJob& job);
+    void                        tickFinalize(uint64_t dt, PfxObjects::Budget& budget);
 
   private:
     enum UboLinkpackage : uint8_t {
@@ -94,6 +115,7 @@ class PfxBucket {
 
       size_t        offset    = 0;
       size_t        count     = 0;
+      bool          simulated = false;
 
       Tempest::Vec3 pos       = {};
       };
@@ -103,13 +125,19 @@ class PfxBucket {
       uint64_t      time = 0;
       };
 
+    // planar(SoA) particle state; life is in ms, dead particles have life==0
     struct ParState final {
-      uint16_t      life=0, maxLife=1;
-      Tempest::Vec3 pos, dir;
+      std::vector<float> life, maxLife;
+      std::vector<float> posX, posY, posZ;
+      std::vector<float> dirX, dirY, dirZ;
+      std::vector<std::vector<Trail>> trail;
 
-      std::vector<Trail> trail;
+      size_t        size() const { return life.size(); }
+      void          resize(size_t sz);
+      void          clear (size_t i);
 
-      float         lifeTime() const;
+      Tempest::Vec3 pos(size_t i) const { return Tempest::Vec3(posX[i],posY[i],posZ[i]); }
+      Tempest::Vec3 dir(size_t i) const { return Tempest::Vec3(dirX[i],dirY[i],dirZ[i]); }
       };
 
     struct Draw {
@@ -134,22 +162,22 @@ class PfxBucket {
     size_t                      allocBlock();
     void                        freeBlock(size_t& s);
 
-    static float                randf();
-    static float                randf(float base, float var);
+    static float                randf(PfxRandom& rng);
+    static float                randf(PfxRandom& rng, float base, float var);
 
     Block&                      getBlock(ImplEmitter& emitter);
     Block&                      getBlock(PfxEmitter&  emitter);
 
     void                        init     (Block& block, ImplEmitter& emitter, size_t particle);
     void                        finalize (size_t particle);
-    void                        tick     (Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt);
-    void                        tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt);
+    void                        tickTrail(size_t particle, const ImplEmitter& emitter, uint64_t dt);
 
-    void                        implTickCommon(uint64_t dt, const Tempest::Vec3& viewPos);
-    void                        implTickDecals(uint64_t dt, const Tempest::Vec3& viewPos);
+    void                        implTickDecals(uint64_t dt);
+    float                       importance(const ImplEmitter& emitter, const PfxObjects::Budget& budget) const;
 
     void                        buildSsboTrails();
-    void                        buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
+    void                        buildGroup(const Block& p, size_t at);
+    void                        buildBilboard(PfxState& v, const Block& p, size_t particle, const uint32_t color,
                                               float szX, float szY, float szZ);
     void                        buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT);
     uint32_t                    mkTrailColor(float clA) const;
@@ -163,15 +191,17 @@ class PfxBucket {
     std::vector<PfxState>       trlCpu;
 
     uint64_t                    maxTrlTime = 0;
-    size_t                      blockSize = 0;
+    size_t                      blockSize  = 0;
+    float                       radius     = 0;
+    uint64_t                    seed       = 0;
+    uint64_t                    emitterSeq = 0;
+    PfxLerp                     lerp;
 
-    std::vector<ParState>       particles;
+    ParState                    particles;
     std::vector<ImplEmitter>    impl;
     std::vector<Block>          block;
     bool                        forceUpdate[Resources::MaxFramesInFlight] = {};
 
-    static std::mt19937         rndEngine;
-
     friend class PfxEmitter;
   };
 
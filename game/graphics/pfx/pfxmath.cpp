@@ -0,0 +1,110 @@
+#include "pfxmath.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+
+uint32_t pfxIntegrate(float* life, float* const pos[3], float* const dir[3], float dt, const float gravity[3]) {
+  const __m128 vdt   = _mm_set1_ps(dt);
+  const __m128 l     = _mm_loadu_ps(life);
+  const __m128 alive = _mm_cmpgt_ps(l,_mm_setzero_ps());
+  const __m128 live  = _mm_cmpgt_ps(l,vdt);
+
+  _mm_storeu_ps(life, _mm_and_ps(live,_mm_sub_ps(l,vdt)));
+  for(size_t c=0; c<3; ++c) {
+    const __m128 p = _mm_loadu_ps(pos[c]);
+    const __m128 d = _mm_loadu_ps(dir[c]);
+    _mm_storeu_ps(pos[c], _mm_and_ps(live,_mm_add_ps(p,_mm_mul_ps(d,vdt))));
+    _mm_storeu_ps(dir[c], _mm_and_ps(live,_mm_add_ps(d,_mm_set1_ps(gravity[c]*dt))));
+    }
+  return uint32_t(_mm_movemask_ps(_mm_andnot_ps(live,alive)));
+  }
+
+void pfxLerp(const float* life, const float* maxLife, const PfxLerp& k, float out[PfxLerpCount][4]) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 a   = _mm_sub_ps(one,_mm_div_ps(_mm_loadu_ps(life),_mm_loadu_ps(maxLife)));
+  for(size_t c=0; c<3; ++c) {
+    const __m128 s = _mm_set1_ps(k.colorS[c]);
+    _mm_storeu_ps(out[PfxLerpR+c], _mm_add_ps(s,_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(k.colorE[c]),s),a)));
+    }
+  const __m128 as    = _mm_set1_ps(k.alphaS);
+  const __m128 scale = _mm_add_ps(one,_mm_mul_ps(_mm_set1_ps(k.sizeEScale-1.f),a));
+  _mm_storeu_ps(out[PfxLerpA],   _mm_add_ps(as,_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(k.alphaE),as),a)));
+  _mm_storeu_ps(out[PfxLerpSzX], _mm_mul_ps(_mm_set1_ps(k.sizeX),scale));
+  _mm_storeu_ps(out[PfxLerpSzY], _mm_mul_ps(_mm_set1_ps(k.sizeY),scale));
+  }
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+
+uint32_t pfxIntegrate(float* life, float* const pos[3], float* const dir[3], float dt, const float gravity[3]) {
+  const float32x4_t vdt   = vdupq_n_f32(dt);
+  const float32x4_t l     = vld1q_f32(life);
+  const uint32x4_t  alive = vcgtq_f32(l,vdupq_n_f32(0));
+  const uint32x4_t  live  = vcgtq_f32(l,vdt);
+
+  const float32x4_t l1 = vsubq_f32(l,vdt);
+  vst1q_f32(life, vreinterpretq_f32_u32(vandq_u32(live,vreinterpretq_u32_f32(l1))));
+  for(size_t c=0; c<3; ++c) {
+    const float32x4_t p  = vld1q_f32(pos[c]);
+    const float32x4_t d  = vld1q_f32(dir[c]);
+    const float32x4_t p1 = vmlaq_f32(p,d,vdt);
+    const float32x4_t d1 = vaddq_f32(d,vdupq_n_f32(gravity[c]*dt));
+    vst1q_f32(pos[c], vreinterpretq_f32_u32(vandq_u32(live,vreinterpretq_u32_f32(p1))));
+    vst1q_f32(dir[c], vreinterpretq_f32_u32(vandq_u32(live,vreinterpretq_u32_f32(d1))));
+    }
+
+  uint32_t died[4];
+  vst1q_u32(died, vbicq_u32(alive,live));
+  return (died[0]&1u) | (died[1]&2u) | (died[2]&4u) | (died[3]&8u);
+  }
+
+void pfxLerp(const float* life, const float* maxLife, const PfxLerp& k, float out[PfxLerpCount][4]) {
+  float at[4];
+  for(size_t i=0; i<4; ++i)
+    at[i] = 1.f-life[i]/maxLife[i];
+  const float32x4_t a = vld1q_f32(at);
+  for(size_t c=0; c<3; ++c) {
+    const float32x4_t s = vdupq_n_f32(k.colorS[c]);
+    vst1q_f32(out[PfxLerpR+c], vmlaq_f32(s,vsubq_f32(vdupq_n_f32(k.colorE[c]),s),a));
+    }
+  const float32x4_t as    = vdupq_n_f32(k.alphaS);
+  const float32x4_t scale = vmlaq_f32(vdupq_n_f32(1.f),vdupq_n_f32(k.sizeEScale-1.f),a);
+  vst1q_f32(out[PfxLerpA],   vmlaq_f32(as,vsubq_f32(vdupq_n_f32(k.alphaE),as),a));
+  vst1q_f32(out[PfxLerpSzX], vmulq_f32(vdupq_n_f32(k.sizeX),scale));
+  vst1q_f32(out[PfxLerpSzY], vmulq_f32(vdupq_n_f32(k.sizeY),scale));
+  }
+
+#else
+
+static float mix(float x,float y,float a){
+  return x+(y-x)*a;
+  }
+
+uint32_t pfxIntegrate(float* life, float* const pos[3], float* const dir[3], float dt, const float gravity[3]) {
+  uint32_t died = 0;
+  for(size_t i=0; i<4; ++i) {
+    const bool live = life[i]>dt;
+    if(life[i]>0 && !live)
+      died |= 1u << i;
+    life[i] = live ? life[i]-dt : 0.f;
+    for(size_t c=0; c<3; ++c) {
+      pos[c][i] = live ? pos[c][i]+dir[c][i]*dt  : 0.f;
+      dir[c][i] = live ? dir[c][i]+gravity[c]*dt : 0.f;
+      }
+    }
+  return died;
+  }
+
+void pfxLerp(const float* life, const float* maxLife, const PfxLerp& k, float out[PfxLerpCount][4]) {
+  for(size_t i=0; i<4; ++i) {
+    const float a     = 1.f-life[i]/maxLife[i];
+    const float scale = mix(1.f,k.sizeEScale,a);
+    for(size_t c=0; c<3; ++c)
+      out[PfxLerpR+c][i] = mix(k.colorS[c],k.colorE[c],a);
+    out[PfxLerpA  ][i] = mix(k.alphaS,k.alphaE,a);
+    out[PfxLerpSzX][i] = k.sizeX*scale;
+    out[PfxLerpSzY][i] = k.sizeY*scale;
+    }
+  }
+
+#endif
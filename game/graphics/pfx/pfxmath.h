@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// planar(SoA) particle kernels: each call processes 4 consecutive particles,
+// particle blocks are padded to a multiple of 4
+enum : size_t {
+  PfxLerpR     = 0,
+  PfxLerpG     = 1,
+  PfxLerpB     = 2,
+  PfxLerpA     = 3,
+  PfxLerpSzX   = 4,
+  PfxLerpSzY   = 5,
+  PfxLerpCount = 6,
+  };
+
+struct PfxLerp final {
+  float colorS[3]  = {};
+  float colorE[3]  = {};
+  float alphaS     = 0;
+  float alphaE     = 0;
+  float sizeX      = 0;
+  float sizeY      = 0;
+  float sizeEScale = 0;
+  };
+
+// life decay and position/velocity integration; dead particles(life==0) are left zeroed
+// returns bit-mask of particles, that expired during this step
+uint32_t pfxIntegrate(float* life, float* const pos[3], float* const dir[3], float dt, const float gravity[3]);
+// colour, alpha and size of particles at 1-life/maxLife
+void     pfxLerp(const float* life, const float* maxLife, const PfxLerp& k, float out[PfxLerpCount][4]);
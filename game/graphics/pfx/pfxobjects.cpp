@@ -7,9 +7,26 @@
 
 #include "pfxbucket.h"
 #include "particlefx.h"
+#include "utils/profiler.h"
+#include "utils/workers.h"
+#include "gothic.h"
 
 using namespace Tempest;
 
+// avoid waking up workers for a handful of small emitters
+static constexpr size_t MinJobsPerTask = 8;
+// fraction of the budget, after which low-importance emitters start to throttle
+static constexpr float  BudgetSoftLimit = 0.75f;
+
+template<class F>
+static void runJobs(std::vector<PfxBucket::SimJob>& jobs, const F& func) {
+  const size_t taskCount = std::min<size_t>(Workers::maxThreads(), (jobs.size()+MinJobsPerTask-1)/MinJobsPerTask);
+  Workers::parallelTasks(taskCount,[&jobs,&func,taskCount](size_t id){
+    for(size_t i=id; i<jobs.size(); i+=taskCount)
+      func(jobs[i]);
+    });
+  }
+
 PfxObjects::PfxObjects(WorldView& world, const SceneGlobals& scene, VisualObjects& visual)
   :world(world), scene(scene), visual(visual) {
   }
@@ -26,6 +43,7 @@ void PfxObjects::resetTicks() {
   }
 
 void PfxObjects::tick(uint64_t ticks) {
+  Profiler::Zone zone("PfxObjects::tick");
   static bool disabled = false;
   if(disabled)
     return;
@@ -39,11 +57,38 @@ void PfxObjects::tick(uint64_t ticks) {
   if(dt==0)
     return;
 
+  Budget budget;
+  budget.viewPos     = viewerPos;
+  budget.frustrum    = &scene.frustrum[SceneGlobals::V_Main];
+  budget.stat.budget = Gothic::inst().pfxBudget();
+  if(budget.stat.budget==0) {
+    budget.left = size_t(-1);
+    } else {
+    const float pressure = float(stat.particles)/float(budget.stat.budget);
+    budget.cutoff = std::clamp((pressure-BudgetSoftLimit)/(1.f-BudgetSoftLimit), 0.f, 1.f);
+    budget.left   = budget.stat.budget>stat.particles ? budget.stat.budget-stat.particles : 0;
+    }
+  budget.stat.cutoff = budget.cutoff;
+
+  std::vector<PfxBucket::SimJob> jobs;
   for(auto& i:bucket)
-    i.tick(dt,viewerPos);
+    i.tickPrepare(dt,budget,jobs);
+
+  // fused simulation and bilboard build
+  runJobs(jobs,[dt](PfxBucket::SimJob& j){ j.owner->simulate(j,dt); });
+  for(auto& i:jobs)
+    i.owner->commit(i);
+
+  // emission: each emitter draws from own random stream
+  jobs.clear();
+  for(auto& i:bucket)
+    i.tickSchedule(dt,budget,jobs);
+  runJobs(jobs,[](PfxBucket::SimJob& j){ j.owner->emit(j); });
 
   for(auto& i:bucket)
-    i.buildSsbo();
+    i.tickFinalize(dt,budget);
+
+  stat = budget.stat;
 
   lastUpdate = ticks;
   }
@@ -10,6 +10,7 @@
 #include "graphics/visualobjects.h"
 
 class SceneGlobals;
+class Frustrum;
 class ParticleFx;
 class PfxBucket;
 class WorldView;
@@ -21,11 +22,29 @@ class PfxObjects final {
 
     static constexpr const float viewRage = 4000.f;
 
+    struct Stats {
+      size_t particles = 0;
+      size_t budget    = 0;
+      size_t emitters  = 0;
+      size_t culled    = 0;
+      float  cutoff    = 0;
+      };
+
+    // per-tick particle budget: emitters below 'cutoff' importance are culled, 'left' caps emission
+    struct Budget {
+      Tempest::Vec3   viewPos;
+      const Frustrum* frustrum = nullptr;
+      float           cutoff   = 0;
+      size_t          left     = 0;
+      Stats           stat;
+      };
+
     void       setViewerPos(const Tempest::Vec3& pos);
 
     void       resetTicks();
     void       tick(uint64_t ticks);
     bool       isInPfxRange(const Tempest::Vec3& pos) const;
+    auto       stats() const -> const Stats& { return stat; }
 
     void       prepareUniforms();
     void       preFrameUpdate(uint8_t fId);
@@ -55,6 +74,7 @@ class PfxObjects final {
 
     Tempest::Vec3                 viewerPos={};
     uint64_t                      lastUpdate=0;
+    Stats                         stat;
 
   friend class PfxEmitter;
   friend class TrlObjects;
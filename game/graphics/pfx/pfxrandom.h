@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// PCG32 (XSH-RR) random stream; same seed and stream produce the same sequence on every platform
+class PfxRandom final {
+  public:
+    PfxRandom() = default;
+    PfxRandom(uint64_t seed, uint64_t stream) {
+      state = 0;
+      inc   = (stream << 1u) | 1u;
+      next();
+      state += seed;
+      next();
+      }
+
+    uint32_t next() {
+      const uint64_t old = state;
+      state = old*6364136223846793005ull + inc;
+      const uint32_t xs  = uint32_t(((old >> 18u) ^ old) >> 27u);
+      const uint32_t rot = uint32_t(old >> 59u);
+      return (xs >> rot) | (xs << ((0u-rot) & 31u));
+      }
+
+    // uniform in [0,1)
+    float    randf() { return float(next() >> 8u)*(1.f/16777216.f); }
+
+  private:
+    uint64_t state = 0x853c49e6748fea9bull;
+    uint64_t inc   = 0xda3e39cb94b95bdbull;
+  };
@@ -9,6 +9,7 @@
 #include "gothic.h"
 #include "ui/videowidget.h"
 #include "utils/string_frm.h"
+#include "utils/profiler.h"
 
 #include <ui/videowidget.h>
 
@@ -235,6 +236,11 @@ void Renderer::onWorldChanged() {
   prepareUniforms();
   }
 
+void Renderer::onTexturesChanged() {
+  prepareUniforms();
+  prepareRtUniforms();
+  }
+
 void Renderer::updateCamera(const Camera& camera) {
   proj        = camera.projective();
   viewProj    = camera.viewProj();
@@ -427,6 +433,7 @@ void Renderer::prepareSky(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t
 void Renderer::draw(Encoder<CommandBuffer>& cmd, uint8_t cmdId, size_t imgId,
                     VectorImage::Mesh& uiLayer, VectorImage::Mesh& numOverlay,
                     InventoryMenu& inventory, VideoWidget& video) {
+  Profiler::Zone zone("Renderer::draw");
   auto& result = swapchain[imgId];
 
   if(!video.isActive()) {
@@ -0,0 +1,67 @@
+#include "rendersnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace Tempest;
+
+static_assert(sizeof(Matrix4x4)==16*sizeof(float));
+
+static void lerpMatrices(const Matrix4x4* a, const Matrix4x4* b, size_t count, float k, Matrix4x4* out) {
+  // steps are short: per-component blend is close enough to slerp of bones
+  auto x = reinterpret_cast<const float*>(a);
+  auto y = reinterpret_cast<const float*>(b);
+  auto o = reinterpret_cast<float*>(out);
+  for(size_t i=0; i<count*16; ++i)
+    o[i] = x[i] + (y[i]-x[i])*k;
+  }
+
+void RenderSnapshot::clear() {
+  static std::atomic<uint64_t> seq{0};
+  id        = ++seq;
+  hasCamera = false;
+  obj.clear();
+  tr.clear();
+  }
+
+uint32_t RenderSnapshot::push(void* owner, Type t, const Matrix4x4& pos, const Matrix4x4* bones, size_t count) {
+  Object o;
+  o.owner = owner;
+  o.type  = t;
+  o.tr    = uint32_t(tr.size());
+  o.count = uint32_t(count+1);
+  tr.push_back(pos);
+  tr.insert(tr.end(), bones, bones+count);
+  obj.push_back(o);
+  return uint32_t(obj.size()-1);
+  }
+
+void RenderSnapshot::lerp(const RenderSnapshot& prev, const RenderSnapshot& cur, float alpha,
+                          std::vector<Matrix4x4>& out, Vec3* camera) {
+  // teleports are not interpolated
+  const float maxLerp = 200.f;
+
+  out.resize(cur.tr.size());
+  for(auto& i:cur.obj) {
+    const Matrix4x4* b = &cur.tr[i.tr];
+    if(alpha>=1.f || i.prev>=prev.obj.size() || prev.obj[i.prev].count!=i.count) {
+      std::copy(b, b+i.count, &out[i.tr]);
+      continue;
+      }
+    const Matrix4x4* a  = &prev.tr[prev.obj[i.prev].tr];
+    const Vec3       dp = Vec3(b->at(3,0),b->at(3,1),b->at(3,2)) - Vec3(a->at(3,0),a->at(3,1),a->at(3,2));
+    if(dp.quadLength()>maxLerp*maxLerp) {
+      std::copy(b, b+i.count, &out[i.tr]);
+      continue;
+      }
+    lerpMatrices(a,b,i.count,alpha,&out[i.tr]);
+    }
+
+  if(camera==nullptr || !cur.hasCamera)
+    return;
+  for(int i=0; i<2; ++i) {
+    camera[i] = cur.camera[i];
+    if(prev.hasCamera && alpha<1.f && (cur.camera[i]-prev.camera[i]).quadLength()<maxLerp*maxLerp)
+      camera[i] = prev.camera[i] + (cur.camera[i]-prev.camera[i])*alpha;
+    }
+  }
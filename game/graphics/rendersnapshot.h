@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Tempest/Matrix4x4>
+#include <Tempest/Vec>
+
+#include <vector>
+#include <cstdint>
+
+// transforms of moving objects, published by logic thread after each step;
+// render thread blends two last snapshots and doesn't touch game state for that
+class RenderSnapshot final {
+  public:
+    enum Type : uint8_t {
+      T_Npc,
+      T_Item,
+      T_Mobsi,
+      };
+
+    enum : uint32_t {
+      NoPrev = uint32_t(-1),
+      };
+
+    struct Object final {
+      void*       owner = nullptr; // valid only while snapshot is the latest one of the world
+      Type        type  = T_Npc;
+      uint32_t    prev  = NoPrev;  // index of same object in previous snapshot
+      uint32_t    tr    = 0;       // offset in 'tr': object matrix, followed by bones
+      uint32_t    count = 0;
+      };
+
+    uint64_t                        id = 0;
+    std::vector<Object>             obj;
+    std::vector<Tempest::Matrix4x4> tr;
+    // camera bone of player: third and first person
+    Tempest::Vec3                   camera[2] = {};
+    bool                            hasCamera = false;
+
+    void     clear();
+    uint32_t push(void* owner, Type t, const Tempest::Matrix4x4& pos, const Tempest::Matrix4x4* bones, size_t count);
+
+    // blends objects of 'cur' with 'prev'; 'out' is parallel to cur.tr
+    static void lerp(const RenderSnapshot& prev, const RenderSnapshot& cur, float alpha,
+                     std::vector<Tempest::Matrix4x4>& out, Tempest::Vec3* camera);
+  };
@@ -4,6 +4,7 @@
 
 #include "graphics/mesh/submesh/animmesh.h"
 #include "gothic.h"
+#include "utils/profiler.h"
 
 using namespace Tempest;
 
@@ -477,6 +478,7 @@ void VisualObjects::prepareGlobals(Encoder<CommandBuffer>& enc, uint8_t fId) {
   }
 
 void VisualObjects::preFrameUpdate(uint8_t fId) {
+  Profiler::Zone zone("VisualObjects::preFrameUpdate");
   preFrameUpdateWind(fId);
   preFrameUpdateMorph(fId);
   }
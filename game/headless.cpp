@@ -0,0 +1,126 @@
+#include "headless.h"
+
+#include <Tempest/Application>
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "game/gamesession.h"
+#include "game/serialize.h"
+#include "commandline.h"
+#include "gamemusic.h"
+#include "gothic.h"
+#include "resources.h"
+
+using namespace Tempest;
+
+HeadlessRunner::HeadlessRunner()
+  :inventory(keycodec), dialogs(inventory), player(dialogs,inventory) {
+  Gothic::inst().onDialogPipe .bind(&dialogs,&DialogMenu::openPipe);
+  Gothic::inst().isDialogClose.bind(&dialogs,&DialogMenu::aiIsClose);
+  Gothic::inst().onWorldLoaded.bind(this,&HeadlessRunner::onWorldLoaded);
+
+  auto rate = CommandLine::inst().logicTickRate();
+  step = std::max<uint64_t>(1000000u/(rate>0 ? rate : 60), 1);
+  }
+
+HeadlessRunner::~HeadlessRunner() {
+  Gothic::inst().onDialogPipe .ubind(&dialogs,&DialogMenu::openPipe);
+  Gothic::inst().isDialogClose.ubind(&dialogs,&DialogMenu::aiIsClose);
+  Gothic::inst().onWorldLoaded.ubind(this,&HeadlessRunner::onWorldLoaded);
+  Gothic::inst().cancelLoading();
+  Gothic::inst().setGame(std::unique_ptr<GameSession>());
+  }
+
+int HeadlessRunner::exec() {
+  auto& cmd = CommandLine::inst();
+  if(!cmd.replayPath().empty() && !replay.load(cmd.replayPath())) {
+    Log::e("headless: unable to read input record: \"",cmd.replayPath(),"\"");
+    return 1;
+    }
+
+  GameMusic::inst().setEnabled(false);
+
+  const uint64_t time0 = Application::tickCount();
+  if(!startGame())
+    return 1;
+  const uint64_t time1 = Application::tickCount();
+  Log::i("headless: world loaded in ",time1-time0,"ms");
+
+  const uint64_t duration = uint64_t(cmd.headlessMinutes())*60*1000;
+  uint64_t       simTime  = 0;
+  uint64_t       stepTime = 0;
+  uint64_t       ticks    = 0;
+  while(simTime<duration) {
+    // recorded input drives the step size, while it lasts
+    uint64_t dt = replay.replay(player);
+    if(dt==0) {
+      // integer milliseconds, distributed so that average matches the rate
+      dt        = (stepTime+step)/1000 - stepTime/1000;
+      stepTime += step;
+      }
+
+    player.tickLogic(dt);
+    // nothing is in flight on GPU: release recycled objects right away
+    Resources::resetRecycled(0);
+
+    simTime += dt;
+    ticks   += 1;
+
+    if(Gothic::inst().checkLoading()!=Gothic::LoadState::Idle && !waitLoading())
+      return 1;
+    if(!Gothic::inst().isInGame())
+      break;
+    }
+
+  const uint64_t wall = std::max<uint64_t>(Application::tickCount()-time1, 1);
+  Log::i("headless: simulated ",simTime/1000,"s in ",ticks," ticks, ",wall,"ms; ",
+         double(simTime)/double(wall),"x realtime, ",double(wall)*1000.0/double(ticks),"us/tick");
+  return 0;
+  }
+
+bool HeadlessRunner::startGame() {
+  auto& gothic = Gothic::inst();
+  if(!gothic.defaultSave().empty()) {
+    gothic.startLoad("",[slot=std::string(gothic.defaultSave())](std::unique_ptr<GameSession>&& game){
+      game = nullptr;
+      Tempest::RFile file(slot);
+      Serialize      s(file);
+      return std::unique_ptr<GameSession>(new GameSession(s));
+      });
+    } else {
+    gothic.startLoad("",[wrld=std::string(gothic.defaultWorld())](std::unique_ptr<GameSession>&& game){
+      game = nullptr;
+      return std::unique_ptr<GameSession>(new GameSession(wrld));
+      });
+    }
+  return waitLoading() && gothic.isInGame();
+  }
+
+bool HeadlessRunner::waitLoading() {
+  auto& gothic = Gothic::inst();
+  while(true) {
+    auto st = gothic.checkLoading();
+    if(st==Gothic::LoadState::Idle)
+      return true;
+    if(st==Gothic::LoadState::FailedLoad || st==Gothic::LoadState::FailedSave) {
+      gothic.finishLoading();
+      Log::e("headless: loading failed");
+      return false;
+      }
+    if(st==Gothic::LoadState::Finalize) {
+      gothic.finishLoading();
+      return true;
+      }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+void HeadlessRunner::onWorldLoaded() {
+  player   .clearInput();
+  inventory.onWorldChanged();
+  dialogs  .onWorldChanged();
+  }
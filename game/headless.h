@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#include "game/playercontrol.h"
+#include "game/inputrecord.h"
+#include "ui/dialogmenu.h"
+#include "ui/inventorymenu.h"
+#include "utils/keycodec.h"
+
+// game logic without window, swapchain and renderer: fixed-step simulation for benchmarking
+class HeadlessRunner final {
+  public:
+    HeadlessRunner();
+    ~HeadlessRunner();
+
+    int exec();
+
+  private:
+    bool          startGame();
+    bool          waitLoading();
+    void          onWorldLoaded();
+
+    KeyCodec      keycodec;
+    InventoryMenu inventory;
+    DialogMenu    dialogs;
+    PlayerControl player;
+    InputRecord   replay;
+
+    // fixed step in microseconds
+    uint64_t      step = 0;
+  };
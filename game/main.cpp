@@ -20,11 +20,13 @@
 
 #include "utils/crashlog.h"
 #include "mainwindow.h"
+#include "headless.h"
 #include "gothic.h"
 #include "build.h"
 #include "commandline.h"
 
 #include <dmusic.h>
+#include <cstdlib>
 
 std::string_view selectDevice(const Tempest::AbstractGraphicsApi& api) {
   auto d = api.devices();
@@ -135,11 +137,21 @@ int main(int argc,const char** argv) {
   Tempest::Device      device{*api,gpuName};
   CrashLog::setGpu(device.properties().name);
 
+  if(cmd.isHeadless() || !cmd.recordPath().empty() || !cmd.replayPath().empty()) {
+    // fixed seed: same input record gives same simulation
+    std::srand(0);
+    }
+
   Resources            resources{device};
   Gothic               gothic;
   GameMusic            music;
   gothic.setupGlobalScripts();
 
+  if(cmd.isHeadless()) {
+    HeadlessRunner hl;
+    return hl.exec();
+    }
+
   MainWindow           wx(device);
   Tempest::Application app;
   return app.exec();
@@ -9,6 +9,8 @@
 #include <Tempest/Application>
 #include <Tempest/Log>
 
+#include <chrono>
+
 #include "ui/dialogmenu.h"
 #include "ui/menuroot.h"
 #include "ui/stacklayout.h"
@@ -21,6 +23,8 @@
 #include "game/globaleffects.h"
 #include "utils/gthfont.h"
 #include "utils/dbgpainter.h"
+#include "utils/workers.h"
+#include "utils/profiler.h"
 
 #include "commandline.h"
 #include "gothic.h"
@@ -111,9 +115,25 @@ MainWindow::MainWindow(Device& device)
 
   displayPos = Shortcut(*this,Event::M_Alt,Event::K_P);
   displayPos.onActivated.bind(this, &MainWindow::onMarvinKey<Event::K_P>);
+
+  if(auto rate = CommandLine::inst().logicTickRate()) {
+    logicStep   = std::max<uint64_t>(1000000u/rate, 1);
+    worldLock   = std::unique_lock<std::mutex>(worldSync);
+    logicThread = std::thread([this]() noexcept { logicThreadFunc(); });
+    }
+
+  if(!CommandLine::inst().recordPath().empty())
+    player.setRecord(&record);
   }
 
 MainWindow::~MainWindow() {
+  if(logicThread.joinable()) {
+    lockWorld();
+    logicExit = true;
+    unlockWorld();
+    logicWait.notify_all();
+    logicThread.join();
+    }
   GameMusic::inst().stopMusic();
   Gothic::inst().cancelLoading();
   device.waitIdle();
@@ -129,6 +149,9 @@ MainWindow::~MainWindow() {
   removeAllWidgets();
   // unload
   Gothic::inst().setGame(std::unique_ptr<GameSession>());
+
+  if(!CommandLine::inst().recordPath().empty())
+    record.save(CommandLine::inst().recordPath());
   }
 
 void MainWindow::setupUi() {
@@ -262,6 +285,24 @@ void MainWindow::paintEvent(PaintEvent& event) {
 
     auto& fnt = Resources::font();
     fnt.drawText(p,5,fnt.pixelSize()+5,fpsT);
+
+    if(world!=nullptr) {
+      // skeletons updated every 1st/2nd/4th/8th frame
+      auto lod = world->animLodStats();
+      string_frm lodT("anim lod = ",lod[0]," / ",lod[1]," / ",lod[2]," / ",lod[3]);
+      fnt.drawText(p,5,2*(fnt.pixelSize()+5),lodT);
+      }
+    }
+
+  if(Profiler::isEnabled() && !Gothic::inst().isDesktop()) {
+    auto& fnt = Resources::font();
+    int   y   = 4*(fnt.pixelSize()+5);
+    for(auto& i:Profiler::top(12)) {
+      char txt[128]={};
+      std::snprintf(txt,sizeof(txt),"%-32s %7.3f ms %7.1f",i.name,i.time,i.count);
+      fnt.drawText(p,5,y,txt);
+      y += fnt.pixelSize()+5;
+      }
     }
 
   if(Gothic::inst().doClock() && world!=nullptr) {
@@ -836,6 +877,8 @@ uint64_t MainWindow::tick() {
     return 0;
   lastTick  = time;
 
+  logicRun = false;
+
   auto st = Gothic::inst().checkLoading();
   if(st==Gothic::LoadState::Finalize || st==Gothic::LoadState::FailedLoad || st==Gothic::LoadState::FailedSave) {
     Gothic::inst().finishLoading();
@@ -863,6 +906,7 @@ uint64_t MainWindow::tick() {
   if(dt>50)
     dt=50;
 
+  const bool step = (runtimeMode==R_Step);
   if(runtimeMode==R_Step) {
     runtimeMode = R_Suspended;
     dt = 1000/60; //60 fps
@@ -877,23 +921,128 @@ uint64_t MainWindow::tick() {
     return dt;
     }
 
-  dialogs.tick(dt);
-  inventory.tick(dt);
-  Gothic::inst().tick(dt);
-  player.tickFocus();
-
-  if(dialogs.isActive())
-    ;//clearInput();
   if(document.isActive())
     clearInput();
   tickMouse();
-  player.tickMove(dt);
+  if(logicStep>0) {
+    // game logic is advanced in fixed steps by logicThread; single debug step runs in place
+    if(step)
+      stepLogic(); else
+      logicRun = true;
+    update();
+    return dt;
+    }
+  player.tickLogic(dt);
   update();
   return dt;
   }
 
-void MainWindow::updateAnimation(uint64_t dt) {
-  Gothic::inst().updateAnimation(dt);
+static uint64_t logicClock() {
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+  return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(t).count());
+  }
+
+void MainWindow::stepLogic() {
+  // integer milliseconds per step, distributed so that average matches the rate
+  const uint64_t dt = (logicTime+logicStep)/1000 - logicTime/1000;
+  logicTime += logicStep;
+  // skeletons are evaluated once per step; render blends published snapshots
+  player.tickLogic(dt);
+  publishSnapshot();
+  }
+
+void MainWindow::publishSnapshot() {
+  // render may still blend from the oldest one
+  if(snapBack==nullptr || snapBack.use_count()>1)
+    snapBack = std::make_shared<RenderSnapshot>();
+  if(auto w = Gothic::inst().world())
+    w->snapshot(*snapBack); else
+    snapBack->clear();
+
+  std::lock_guard<std::mutex> guard(snapSync);
+  std::swap(snapPrev,snapBack);
+  std::swap(snapPrev,snapCur);
+  logicLast = logicClock();
+  }
+
+void MainWindow::applySnapshot() {
+  // blending reads published snapshots only, so world is released meanwhile
+  std::shared_ptr<RenderSnapshot> prev, cur;
+  auto blend = [&]() {
+    uint64_t last = 0;
+    {
+    std::lock_guard<std::mutex> guard(snapSync);
+    prev = snapPrev;
+    cur  = snapCur;
+    last = logicLast;
+    }
+    if(cur==nullptr)
+      return;
+    const uint64_t since = std::min(logicClock()-last, logicStep);
+    const float    alpha = float(since)/float(logicStep);
+    RenderSnapshot::lerp(prev!=nullptr ? *prev : *cur, *cur, alpha, snapFrame, snapCamera);
+    };
+
+  unlockWorld();
+  blend();
+  lockWorld();
+
+  auto w = Gothic::inst().world();
+  if(w==nullptr || cur==nullptr) {
+    snapCameraValid = false;
+    return;
+    }
+  if(!w->applySnapshot(*cur,snapFrame)) {
+    // logic did a step in between; it can't publish, while world is locked
+    blend();
+    w->applySnapshot(*cur,snapFrame);
+    }
+  snapCameraValid = cur->hasCamera;
+  }
+
+void MainWindow::logicThreadFunc() {
+  Workers::setThreadName("Game logic thread");
+  std::unique_lock<std::mutex> lck(worldSync);
+  uint64_t last = logicClock();
+  while(!logicExit) {
+    if(renderWait) {
+      // hand world over to main thread: it waits for at most one step
+      logicWait.wait(lck,[this](){ return !renderWait || logicExit; });
+      continue;
+      }
+    const uint64_t now = logicClock();
+    if(logicRun && Gothic::inst().checkLoading()==Gothic::LoadState::Idle)
+      logicAcc = std::min(logicAcc+(now-last), logicStep*MaxLogicSteps); else
+      logicAcc = 0;
+    last = now;
+
+    uint64_t wait = logicStep;
+    if(logicAcc>=logicStep) {
+      logicAcc -= logicStep;
+      stepLogic();
+      wait = 0;
+      }
+    else if(logicRun) {
+      wait = logicStep-logicAcc;
+      }
+    if(wait>0)
+      logicWait.wait_for(lck,std::chrono::microseconds(wait));
+    }
+  }
+
+void MainWindow::lockWorld() {
+  if(worldLock.mutex()==nullptr || worldLock.owns_lock())
+    return;
+  renderWait = true;
+  worldLock.lock();
+  renderWait = false;
+  }
+
+void MainWindow::unlockWorld() {
+  if(!worldLock.owns_lock())
+    return;
+  worldLock.unlock();
+  logicWait.notify_all();
   }
 
 void MainWindow::tickCamera(uint64_t dt) {
@@ -908,6 +1057,8 @@ void MainWindow::tickCamera(uint64_t dt) {
                              ws==WeaponState::W1H  ||
                              ws==WeaponState::W2H);
   auto       pos          = pl->cameraBone(camera.isFirstPerson());
+  if(logicStep>0 && snapCameraValid)
+    pos = snapCamera[camera.isFirstPerson() ? 1 : 0];
 
   if(!camera.isCutscene()) {
     const bool fs = SystemApi::isFullscreen(hwnd());
@@ -1028,6 +1179,12 @@ void MainWindow::saveGame(std::string_view slot, std::string_view name) {
   if(auto w = Gothic::inst().world(); w!=nullptr && w->currentCs()!=nullptr)
     return;
 
+  if(Gothic::inst().isSnapshotSave()) {
+    // world stays in play; compression and file io are done in background
+    Gothic::inst().startSnapshotSave(slot,name,pm);
+    return;
+    }
+
   Gothic::inst().startSave(std::move(textureCast(tex)),[slot=std::string(slot),name=std::string(name),pm](std::unique_ptr<GameSession>&& game){
     if(!game)
       return std::move(game);
@@ -1058,6 +1215,8 @@ void MainWindow::onWorldLoaded() {
   dMouse = Point();
 
   player   .clearInput();
+  // record starts with a freshly loaded session, to be replayed against same -w/-save
+  record   .clear();
   inventory.onWorldChanged();
   dialogs  .onWorldChanged();
 
@@ -1077,6 +1236,7 @@ void MainWindow::onWorldLoaded() {
   if(auto pl = Gothic::inst().player())
     pl->multSpeed(1.f);
   lastTick = Application::tickCount();
+  logicAcc = 0;
   player.clearFocus();
   }
 
@@ -1113,16 +1273,27 @@ void MainWindow::render(){
       lastly - camera position
       */
     const uint64_t dt = tick();
-    updateAnimation(dt);
+    if(logicStep>0)
+      applySnapshot();
     tickCamera(dt);
 
     auto& sync = fence[cmdId];
     if(!sync.wait(0)) {
       // GPU rendering is not done, pass to next frame
+      unlockWorld();
       std::this_thread::yield();
+      lockWorld();
       return;
       }
     Resources::resetRecycled(cmdId);
+    if(Gothic::inst().checkLoading()==Gothic::LoadState::Idle && Resources::hasTexturesReady() &&
+       Application::tickCount()-lastTexCommit>=TexCommitInterval) {
+      // world descriptor sets are shared by all frames in flight
+      device.waitIdle();
+      Resources::commitTextures();
+      renderer.onTexturesChanged();
+      lastTexCommit = Application::tickCount();
+      }
 
     if(video.isActive()) {
       video.paint(device,cmdId);
@@ -1145,6 +1316,8 @@ void MainWindow::render(){
     auto enc = cmd.startEncoding(device);
     renderer.draw(enc,cmdId,swapchain.currentImage(),uiMesh[cmdId],numMesh[cmdId],inventory,video);
     }
+    // scene is recorded; game logic can run concurrently with submit/present
+    unlockWorld();
     device.submit(cmd,sync);
     device.present(swapchain);
     cmdId = (cmdId+1u)%Resources::MaxFramesInFlight;
@@ -1162,8 +1335,11 @@ void MainWindow::render(){
       }
     fps.push(t-time);
     time = t;
+    Profiler::frame();
+    lockWorld();
     }
   catch(const Tempest::SwapchainSuboptimal&) {
+    lockWorld();
     Log::e("swapchain is outdated - reset renderer");
     device.waitIdle();
     swapchain.reset();
@@ -21,11 +21,16 @@
 
 #include <vector>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 #include "world/world.h"
 #include "world/focus.h"
 #include "game/playercontrol.h"
+#include "game/inputrecord.h"
 #include "graphics/renderer.h"
+#include "graphics/rendersnapshot.h"
 #include "ui/dialogmenu.h"
 #include "ui/inventorymenu.h"
 #include "ui/chapterscreen.h"
@@ -94,7 +99,12 @@ class MainWindow : public Tempest::Window {
     void render() override;
 
     uint64_t tick();
-    void     updateAnimation(uint64_t dt);
+    void     stepLogic();
+    void     publishSnapshot();
+    void     applySnapshot();
+    void     logicThreadFunc();
+    void     lockWorld();
+    void     unlockWorld();
     void     tickCamera(uint64_t dt);
     void     isDialogClosed(bool& ret);
 
@@ -156,7 +166,11 @@ class MainWindow : public Tempest::Window {
     Tempest::Widget*          uiKeyUp=nullptr;
     Tempest::Point            dMouse;
     PlayerControl             player;
+    InputRecord               record;
     uint64_t                  lastTick=0;
+    // async textures are swapped in batches, behind waitIdle
+    enum { TexCommitInterval = 250 };
+    uint64_t                  lastTexCommit=0;
 
     Tempest::Shortcut         funcKey[11];
     Tempest::Shortcut         displayPos;
@@ -168,4 +182,27 @@ class MainWindow : public Tempest::Window {
       };
     Fps        fps;
     uint64_t   maxFpsInv = 0;
+
+    // fixed-step game logic on logicThread, timed in microseconds;
+    // main thread takes the world for input and draw; logic yields it after a step, once main thread waits
+    enum { MaxLogicSteps = 4 };
+    uint64_t                  logicStep = 0;
+    uint64_t                  logicAcc  = 0;
+    uint64_t                  logicTime = 0;
+    uint64_t                  logicLast = 0;
+    bool                      logicRun  = false;
+    bool                      logicExit = false;
+    std::thread               logicThread;
+    std::mutex                worldSync;
+    std::unique_lock<std::mutex> worldLock;
+    std::condition_variable   logicWait;
+    std::atomic_bool          renderWait{false};
+
+    // snapshots of two last steps, swapped under snapSync; render blends them into snapFrame
+    std::mutex                      snapSync;
+    std::shared_ptr<RenderSnapshot> snapPrev, snapCur;
+    std::shared_ptr<RenderSnapshot> snapBack;
+    std::vector<Tempest::Matrix4x4> snapFrame;
+    Tempest::Vec3                   snapCamera[2] = {};
+    bool                            snapCameraValid = false;
   };
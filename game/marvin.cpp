@@ -5,6 +5,7 @@
 #include <cctype>
 
 #include "utils/string_frm.h"
+#include "utils/profiler.h"
 #include "world/objects/npc.h"
 #include "world/objects/item.h"
 #include "world/triggers/abstracttrigger.h"
@@ -132,6 +133,14 @@ Marvin::Marvin() {
     {"insert %c",                  C_Insert},
 
     {"toggle gi",                  C_ToggleGI},
+    {"toggle parallelnpc",         C_ToggleParallelNpc},
+    {"toggle animlod",             C_ToggleAnimLod},
+    {"toggle snapshotsave",        C_ToggleSnapshotSave},
+    {"toggle profiler",            C_ToggleProfiler},
+    {"dump profiler",              C_DumpProfiler},
+    {"set pfxbudget %d",           C_SetPfxBudget},
+    {"pfx stats",                  C_PfxStats},
+    {"toggle lightclusters",       C_ToggleLightClusters},
     };
   }
 
@@ -371,6 +380,48 @@ bool Marvin::exec(std::string_view v) {
       Gothic::inst().toggleDesktop();
       return true;
       }
+    case C_ToggleParallelNpc: {
+      Gothic::inst().setParallelNpcTick(!Gothic::inst().isParallelNpcTick());
+      return true;
+      }
+    case C_ToggleAnimLod: {
+      Gothic::inst().setAnimLod(!Gothic::inst().isAnimLod());
+      return true;
+      }
+    case C_ToggleSnapshotSave: {
+      Gothic::inst().setSnapshotSave(!Gothic::inst().isSnapshotSave());
+      return true;
+      }
+    case C_ToggleProfiler: {
+      Profiler::setEnabled(!Profiler::isEnabled());
+      return true;
+      }
+    case C_DumpProfiler: {
+      if(!Profiler::dumpTrace("profile.json"))
+        return false;
+      print("trace written to profile.json");
+      return true;
+      }
+    case C_SetPfxBudget: {
+      int  n   = 0;
+      auto err = std::from_chars(ret.argv[0].data(),ret.argv[0].data()+ret.argv[0].size(),n).ec;
+      if(err!=std::errc() || n<0)
+        return false;
+      Gothic::inst().setPfxBudget(size_t(n));
+      return true;
+      }
+    case C_ToggleLightClusters: {
+      Gothic::inst().setLightClusters(!Gothic::inst().isLightClusters());
+      return true;
+      }
+    case C_PfxStats: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr || world->view()==nullptr)
+        return false;
+      auto& st = world->view()->pfxGroup.stats();
+      print(string_frm("particles: ",st.particles,"/",st.budget," emitters: ",st.emitters," culled: ",st.culled));
+      return true;
+      }
     case C_Insert: {
       World* world  = Gothic::inst().world();
       Npc*   player = Gothic::inst().player();
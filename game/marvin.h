@@ -29,6 +29,14 @@ class Marvin {
       C_ToggleTime,
       // game
       C_ToggleDesktop,
+      C_ToggleParallelNpc,
+      C_ToggleAnimLod,
+      C_ToggleSnapshotSave,
+      C_ToggleProfiler,
+      C_DumpProfiler,
+      C_SetPfxBudget,
+      C_PfxStats,
+      C_ToggleLightClusters,
       // npc
       C_CheatFull,
       C_CheatGod,
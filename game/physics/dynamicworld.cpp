@@ -12,6 +12,8 @@
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "utils/workers.h"
+#include "utils/profiler.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
@@ -601,6 +603,22 @@ DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const T
   return ret;
   }
 
+std::vector<uint64_t> DynamicWorld::losBatch(const LosRay* rays, size_t count) const {
+  std::vector<uint8_t>  hit(count);
+  std::vector<uint64_t> ret((count+63)/64);
+
+  const size_t tasks = std::min<size_t>(Workers::maxThreads()+1, (count+7)/8);
+  Workers::parallelTasks(tasks,[&](size_t id){
+    for(size_t i=id; i<count; i+=tasks)
+      hit[i] = ray(rays[i].from,rays[i].to).hasCol ? 1 : 0;
+    });
+
+  for(size_t i=0; i<count; ++i)
+    if(hit[i])
+      ret[i/64] |= (uint64_t(1) << (i%64));
+  return ret;
+  }
+
 DynamicWorld::RayQueryResult DynamicWorld::rayNpc(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
   RayQueryResult r;
   static_cast<RayLandResult&>(r) = ray(from,to);
@@ -817,7 +835,12 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
     }
   }
 
+void DynamicWorld::updateAabbs() {
+  world->updateAabbs();
+  }
+
 void DynamicWorld::tick(uint64_t dt) {
+  Profiler::Zone zone("DynamicWorld::tick");
   npcList   ->tickAabbs();
   bulletList->tick(dt);
   world     ->tick(dt);
@@ -4,6 +4,7 @@
 
 #include <Tempest/Matrix4x4>
 #include <memory>
+#include <vector>
 #include <limits>
 
 class btTriangleIndexVertexArray;
@@ -149,6 +150,11 @@ class DynamicWorld final {
       Npc* npcHit = nullptr;
       };
 
+    struct LosRay {
+      Tempest::Vec3       from;
+      Tempest::Vec3       to;
+      };
+
     struct BulletCallback {
       virtual ~BulletCallback()=default;
       virtual void onStop(){}
@@ -232,6 +238,8 @@ class DynamicWorld final {
     RayLandResult  ray          (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     RayQueryResult rayNpc       (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     float          soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    // bit i of result is set, if rays[i] is blocked by landscape/objects; rays are traced in parallel
+    std::vector<uint64_t> losBatch(const LosRay* rays, size_t count) const;
 
     NpcItem        ghostObj  (std::string_view visual);
     Item           staticObj (const PhysicMeshShape *src, const Tempest::Matrix4x4& m);
@@ -243,6 +251,8 @@ class DynamicWorld final {
     BBoxBody       bboxObj(BBoxCallback* cb, const Tempest::Vec3& pos, float R);
 
     void           tick(uint64_t dt);
+    // brings broadphase up to date, so ray queries above don't mutate it and can run in parallel
+    void           updateAabbs();
 
     void           deleteObj(BulletBody* obj);
 
@@ -29,9 +29,11 @@
 #include "graphics/material.h"
 #include "dmusic/directmusic.h"
 #include "utils/fileext.h"
+#include "utils/fnv.h"
 #include "utils/gthfont.h"
 
 #include "gothic.h"
+#include "commandline.h"
 #include "utils/string_frm.h"
 
 #include <dmusic.h>
@@ -75,9 +77,6 @@ Resources::Resources(Tempest::Device &device)
   // switch-build
   dxMusic->addPath(Gothic::nestedPath({u"_work",u"Data",u"Music"},Dir::FT_Dir));
 
-  fBuff .reserve(8*1024*1024);
-  ddsBuf.reserve(8*1024*1024);
-
   {
   Pixmap pm(1,1,TextureFormat::RGBA8);
   uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
@@ -147,15 +146,23 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
            std::make_tuple(bIsMod,b.time,int(b.ord));
     });
 
+  // transcoded assets are valid as long as set of archives and their timestamps is the same
+  uint64_t fingerprint = Fnv::Basis;
+  for(auto& i:archives) {
+    auto name = TextCodec::toUtf8(i.name);
+    fingerprint = Fnv::hash(name.data(),name.size(),fingerprint);
+    fingerprint = Fnv::hash(&i.time,sizeof(i.time),fingerprint);
+    }
+  inst->trCache.setup(u"cache/",fingerprint);
+
   for(auto& i:archives) {
     try {
-      auto in = zenkit::Read::from(i.name);
 #ifdef __IOS__
       // causes OOM on iPhone7
       if(i.name.find(u"Speech")!=std::string::npos)
         continue;
 #endif
-      inst->gothicAssets.mount_disk(i.name, zenkit::VfsOverwriteBehavior::OLDER);
+      inst->mountVdf(i);
       }
     catch(const zenkit::VfsBrokenDiskError& err) {
       Log::e("unable to load archive: \"", TextCodec::toUtf8(i.name), "\", reason: ", err.what());
@@ -174,6 +181,7 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
   }
 
 Resources::~Resources() {
+  texDecode.wait();
   DmLoader_release(dmLoader);
   inst=nullptr;
   }
@@ -186,6 +194,12 @@ bool Resources::hasFile(std::string_view name) {
 bool Resources::getFileData(std::string_view name, std::vector<uint8_t> &dat) {
   dat.clear();
 
+  auto view = getFileView(name);
+  if(!view.empty()) {
+    dat.assign(view.begin(),view.end());
+    return true;
+    }
+
   const auto* entry = Resources::vdfsIndex().find(name);
   if(entry==nullptr)
     return false;
@@ -208,12 +222,27 @@ std::vector<uint8_t> Resources::getFileData(std::string_view name) {
   }
 
 std::unique_ptr<zenkit::Read> Resources::getFileBuffer(std::string_view name) {
+  auto view = getFileView(name);
+  if(!view.empty())
+    return zenkit::Read::from(reinterpret_cast<const std::byte*>(view.data()),view.size());
+
   const auto* entry = Resources::vdfsIndex().find(name);
   if (entry == nullptr)
     throw std::runtime_error("failed to open resource: " + std::string{name});
   return entry->open_read();
   }
 
+std::span<const uint8_t> Resources::getFileView(std::string_view name) {
+  // resolved by gothicAssets, same as hasFile; host files (music) have no view
+  const auto* node = inst->gothicAssets.find(name);
+  if(node==nullptr)
+    return {};
+  auto it = inst->vdfNodes.find(node);
+  if(it==inst->vdfNodes.end())
+    return {};
+  return it->second;
+  }
+
 const char* Resources::renderer() {
   return inst->dev.properties().name;
   }
@@ -287,6 +316,10 @@ const zenkit::Vfs& Resources::vdfsIndex() {
   return inst->gothicAssets;
   }
 
+const AssetCache& Resources::assetCache() {
+  return inst->trCache;
+  }
+
 const Tempest::VertexBuffer<Resources::VertexFsq> &Resources::fsqVbo() {
   return inst->fsq;
   }
@@ -314,6 +347,76 @@ int64_t Resources::vdfTimestamp(const std::u16string& name) {
     }
   }
 
+void Resources::mountVdf(const Archive& a) {
+  enum {
+    VDF_COMMENT_LENGTH   = 256,
+    VDF_SIGNATURE_LENGTH = 16,
+    VDF_HEADER_LENGTH    = VDF_COMMENT_LENGTH + VDF_SIGNATURE_LENGTH + 6*4,
+    VDF_ENTRY_NAME       = 64,
+    VDF_ENTRY_LENGTH     = VDF_ENTRY_NAME + 4*4,
+    };
+  static constexpr uint32_t VDF_ENTRY_DIRECTORY = 0x80000000;
+
+  struct Entry {
+    std::string              name;
+    std::span<const uint8_t> data;
+    const zenkit::VfsNode*   prev     = nullptr;
+    std::time_t              prevTime = 0;
+    };
+
+  MappedFile fin;
+  if(!fin.open(a.name) || fin.size()<VDF_HEADER_LENGTH) {
+    gothicAssets.mount_disk(a.name, zenkit::VfsOverwriteBehavior::OLDER);
+    return;
+    }
+
+  auto rd32 = [&fin](size_t at) {
+    uint32_t v = 0;
+    std::memcpy(&v,fin.data()+at,sizeof(v));
+    return v;
+    };
+
+  const size_t hdr     = VDF_COMMENT_LENGTH + VDF_SIGNATURE_LENGTH;
+  const size_t count   = rd32(hdr);
+  const size_t catalog = rd32(hdr+16);
+  std::vector<Entry> entry;
+  if(catalog+count*VDF_ENTRY_LENGTH <= fin.size()) {
+    entry.reserve(count);
+    for(size_t i=0; i<count; ++i) {
+      const size_t at   = catalog + i*VDF_ENTRY_LENGTH;
+      const size_t off  = rd32(at+VDF_ENTRY_NAME);
+      const size_t sz   = rd32(at+VDF_ENTRY_NAME+4);
+      const uint32_t tp = rd32(at+VDF_ENTRY_NAME+8);
+      if((tp & VDF_ENTRY_DIRECTORY)!=0 || off+sz > fin.size())
+        continue;
+
+      Entry e;
+      e.name.assign(reinterpret_cast<const char*>(fin.data()+at),VDF_ENTRY_NAME);
+      while(!e.name.empty() && (e.name.back()==' ' || e.name.back()=='\0'))
+        e.name.pop_back();
+      e.data = std::span<const uint8_t>(fin.data()+off,sz);
+      if(auto n = gothicAssets.find(e.name)) {
+        e.prev     = n;
+        e.prevTime = n->time();
+        }
+      entry.emplace_back(std::move(e));
+      }
+    }
+
+  gothicAssets.mount_disk(a.name, zenkit::VfsOverwriteBehavior::OLDER);
+
+  // zenkit decides which node wins: a node is taken from this archive, if it's new or was replaced
+  for(auto& e:entry) {
+    auto n = gothicAssets.find(e.name);
+    if(n==nullptr || (e.prev==n && e.prevTime==n->time()))
+      continue;
+    if(e.prev!=nullptr)
+      vdfNodes.erase(e.prev);
+    vdfNodes[n] = e.data;
+    }
+  vdfMaps.emplace_back(std::move(fin));
+  }
+
 Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_view cname) {
   if(cname.empty())
     return nullptr;
@@ -332,32 +435,12 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
       return it->second.get();
 
     if(const auto* entry = Resources::vdfsIndex().find(name)) {
-      zenkit::Texture tex;
-
-      auto reader = entry->open_read();
-      tex.load(reader.get());
-
-      if (tex.format() == zenkit::TextureFormat::DXT1 ||
-          tex.format() == zenkit::TextureFormat::DXT2 ||
-          tex.format() == zenkit::TextureFormat::DXT3 ||
-          tex.format() == zenkit::TextureFormat::DXT4 ||
-          tex.format() == zenkit::TextureFormat::DXT5) {
-        auto dds = zenkit::to_dds(tex);
-        auto ddsRead = zenkit::Read::from(dds);
-
-        auto t = implLoadTexture(cache, std::string(cname), *ddsRead);
-        if(t!=nullptr)
-          return t;
-        } else {
-        auto rgba = tex.as_rgba8(0);
-
+      Tempest::Pixmap pm;
+      if(decodeTexture(*entry,name,true,pm)) {
         try {
-          Tempest::Pixmap    pm(tex.width(), tex.height(), TextureFormat::RGBA8);
-          std::memcpy(pm.data(), rgba.data(), rgba.size());
-
           std::unique_ptr<Texture2d> t{new Texture2d(dev.texture(pm))};
           Texture2d* ret=t.get();
-          cache[std::move(name)] = std::move(t);
+          cache[std::string(cname)] = std::move(t);
           return ret;
           }
         catch (...) {
@@ -396,21 +479,187 @@ Texture2d *Resources::implLoadTexture(TextureCache& cache, std::string&& name, z
     }
   }
 
+Tempest::Texture2d* Resources::implLoadTextureAsync(std::string_view cname) {
+  if(cname.empty())
+    return nullptr;
+
+  std::string name = std::string(cname);
+  auto it=texCache.find(name);
+  if(it!=texCache.end())
+    return it->second.get();
+
+  const zenkit::VfsNode* entry    = nullptr;
+  bool                   compiled = false;
+  std::string            cTex;
+  if(FileExt::hasExt(name,"TGA")) {
+    cTex = name;
+    cTex.resize(cTex.size() + 2);
+    std::memcpy(&cTex[0]+cTex.size()-6,"-C.TEX",6);
+
+    it=texCache.find(cTex);
+    if(it!=texCache.end())
+      return it->second.get();
+
+    entry    = Resources::vdfsIndex().find(cTex);
+    compiled = (entry!=nullptr);
+    }
+  if(entry==nullptr)
+    entry = Resources::vdfsIndex().find(cname);
+  if(entry==nullptr) {
+    texCache[name]=nullptr;
+    return nullptr;
+    }
+
+  std::unique_ptr<Texture2d> t{new Texture2d(mkPlaceholder(*entry,compiled))};
+  Texture2d* ret=t.get();
+  texCache[std::move(name)] = std::move(t);
+
+  texDecode.run([this,ret,entry,compiled,cTex=std::move(cTex)]() {
+    TexUpload u;
+    if(!decodeTexture(*entry,cTex,compiled,u.pm))
+      return;
+    u.dst = ret;
+    std::lock_guard<std::mutex> guard(syncTex);
+    texReady.emplace_back(std::move(u));
+    });
+  return ret;
+  }
+
+Tempest::Texture2d Resources::mkPlaceholder(const zenkit::VfsNode& entry, bool compiled) {
+  // ZTEX header: signature, version, format, width, height, mip-count, ref-width, ref-height, average color
+  uint32_t hdr[9] = {};
+  if(compiled) {
+    try {
+      auto reader = entry.open_read();
+      reader->read(hdr,sizeof(hdr));
+      }
+    catch(...) {
+      compiled = false;
+      }
+    }
+
+  uint8_t clr[4] = {128,128,128,255};
+  if(compiled) {
+    clr[0] = uint8_t(hdr[8]>>16);
+    clr[1] = uint8_t(hdr[8]>>8);
+    clr[2] = uint8_t(hdr[8]);
+    clr[3] = 255;
+    }
+
+  if(compiled && zenkit::TextureFormat(hdr[2])==zenkit::TextureFormat::DXT1) {
+    // material classification depends on DXT1, so placeholder has to be DXT1 as well: 4x4 dds, single block
+    uint32_t dds[32+2] = {};
+    dds[0]  = 0x20534444; // "DDS "
+    dds[1]  = 124;
+    dds[2]  = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+    dds[3]  = 4;
+    dds[4]  = 4;
+    dds[5]  = 8;
+    dds[7]  = 1;
+    dds[19] = 32;
+    dds[20] = 0x4;
+    dds[21] = 0x31545844; // "DXT1"
+    dds[27] = 0x1000;
+    dds[32] = uint32_t((clr[0]>>3)<<11 | (clr[1]>>2)<<5 | (clr[2]>>3));
+    try {
+      Tempest::MemReader rd(reinterpret_cast<uint8_t*>(dds), sizeof(dds));
+      Tempest::Pixmap    pm(rd);
+      return dev.texture(pm);
+      }
+    catch(...) {
+      }
+    }
+
+  Pixmap pm(1,1,TextureFormat::RGBA8);
+  std::memcpy(pm.data(),clr,sizeof(clr));
+  return dev.texture(pm);
+  }
+
+bool Resources::decodeTexture(const zenkit::VfsNode& entry, std::string_view name, bool compiled, Tempest::Pixmap& out) {
+  using TextureBlob = AssetCache::TextureBlob;
+  try {
+    if(compiled) {
+      AssetCache::Reader rd;
+      TextureBlob        blob;
+      if(assetCache().load(AssetCache::K_Texture,name,rd) && AssetCache::readTexture(rd,blob)) {
+        if(blob.type==TextureBlob::Dds) {
+          Tempest::MemReader mem(const_cast<uint8_t*>(blob.data.data()), blob.data.size());
+          out = Tempest::Pixmap(mem);
+          } else {
+          out = Tempest::Pixmap(blob.width, blob.height, TextureFormat::RGBA8);
+          std::memcpy(out.data(), blob.data.data(), blob.data.size());
+          }
+        return true;
+        }
+
+      auto reader = entry.open_read();
+      zenkit::Texture tex;
+      tex.load(reader.get());
+
+      std::vector<std::byte> dds;
+      std::vector<uint8_t>   rgba;
+      blob.width  = tex.width();
+      blob.height = tex.height();
+      if (tex.format() == zenkit::TextureFormat::DXT1 ||
+          tex.format() == zenkit::TextureFormat::DXT2 ||
+          tex.format() == zenkit::TextureFormat::DXT3 ||
+          tex.format() == zenkit::TextureFormat::DXT4 ||
+          tex.format() == zenkit::TextureFormat::DXT5) {
+        dds = zenkit::to_dds(tex);
+        Tempest::MemReader mem(reinterpret_cast<uint8_t*>(dds.data()), dds.size());
+        out = Tempest::Pixmap(mem);
+        blob.type = TextureBlob::Dds;
+        blob.data = std::span(reinterpret_cast<const uint8_t*>(dds.data()), dds.size());
+        } else {
+        rgba = tex.as_rgba8(0);
+        out = Tempest::Pixmap(tex.width(), tex.height(), TextureFormat::RGBA8);
+        std::memcpy(out.data(), rgba.data(), rgba.size());
+        blob.type = TextureBlob::Rgba;
+        blob.data = rgba;
+        }
+
+      AssetCache::Writer wr;
+      AssetCache::writeTexture(wr,blob);
+      assetCache().save(AssetCache::K_Texture,name,wr);
+      return true;
+      }
+
+    auto reader = entry.open_read();
+    std::vector<uint8_t> raw;
+    reader->seek(0, zenkit::Whence::END);
+    raw.resize(reader->tell());
+    reader->seek(0, zenkit::Whence::BEG);
+    reader->read(raw.data(), raw.size());
+
+    Tempest::MemReader rd(raw.data(), raw.size());
+    out = Tempest::Pixmap(rd);
+    return true;
+    }
+  catch(...) {
+    return false;
+    }
+  }
+
 ProtoMesh* Resources::implLoadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
 
   auto cname = std::string(name);
-  auto it    = aniMeshCache.find(cname);
+  {
+  std::lock_guard<std::recursive_mutex> g(sync);
+  auto it = aniMeshCache.find(cname);
   if(it!=aniMeshCache.end())
     return it->second.get();
+  }
+
+  // decode outside of cache lock, so independent meshes can load in parallel
+  auto t = implLoadMeshMain(cname);
 
-  auto  t   = implLoadMeshMain(cname);
-  auto  ret = t.get();
-  aniMeshCache[cname] = std::move(t);
-  if(ret==nullptr)
+  std::lock_guard<std::recursive_mutex> g(sync);
+  auto [it,emplaced] = aniMeshCache.try_emplace(cname,std::move(t));
+  if(emplaced && it->second==nullptr)
     Log::e("unable to load mesh \"",cname,"\"");
-  return ret;
+  return it->second.get();
   }
 
 std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
@@ -429,7 +678,7 @@ std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
     if(zmsh.sub_meshes.empty())
       return nullptr;
 
-    PackedMesh packed(zmsh,PackedMesh::PK_Visual);
+    PackedMesh packed(zmsh,PackedMesh::PK_Visual,name);
     return std::unique_ptr<ProtoMesh>{new ProtoMesh(std::move(packed),name)};
     }
 
@@ -447,7 +696,7 @@ std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
     if(zmm.mesh.sub_meshes.empty())
       return nullptr;
 
-    PackedMesh packed(zmm.mesh,PackedMesh::PK_VisualMorph);
+    PackedMesh packed(zmm.mesh,PackedMesh::PK_VisualMorph,name);
     return std::unique_ptr<ProtoMesh>{new ProtoMesh(std::move(packed),zmm.animations,name)};
     }
 
@@ -552,7 +801,7 @@ PfxEmitterMesh* Resources::implLoadEmiterMesh(std::string_view name) {
     if(zmsh.sub_meshes.empty())
       return nullptr;
 
-    PackedMesh packed(zmsh,PackedMesh::PK_Visual);
+    PackedMesh packed(zmsh,PackedMesh::PK_Visual,cname);
     ret = std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(packed));
     return ret.get();
     }
@@ -658,10 +907,15 @@ Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
   if(name.empty())
     return Tempest::Sound();
 
-  if(!getFileData(name,fBuff))
-    return Tempest::Sound();
+  std::vector<uint8_t> data;
+  auto view = getFileView(name);
+  if(view.empty()) {
+    if(!getFileData(name,data))
+      return Tempest::Sound();
+    view = data;
+    }
   try {
-    Tempest::MemReader rd(fBuff.data(),fBuff.size());
+    Tempest::MemReader rd(view.data(),view.size());
     return Tempest::Sound(rd);
     }
   catch(...) {
@@ -742,6 +996,44 @@ const Texture2d *Resources::loadTexture(std::string_view name) {
   return inst->implLoadTexture(inst->texCache,name);
   }
 
+const Texture2d* Resources::loadTextureAsync(std::string_view name) {
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  // no render loop to commit uploads
+  if(CommandLine::inst().isHeadless())
+    return inst->implLoadTexture(inst->texCache,name);
+  return inst->implLoadTextureAsync(name);
+  }
+
+bool Resources::hasTexturesReady() {
+  std::lock_guard<std::mutex> guard(inst->syncTex);
+  return !inst->texReady.empty();
+  }
+
+bool Resources::commitTextures() {
+  std::vector<TexUpload> ready;
+  {
+  std::lock_guard<std::mutex> guard(inst->syncTex);
+  auto& q   = inst->texReady;
+  auto  cnt = std::min<size_t>(q.size(), MaxTexUploadsPerCommit);
+  ready.assign(std::make_move_iterator(q.begin()), std::make_move_iterator(q.begin()+int(cnt)));
+  q.erase(q.begin(), q.begin()+int(cnt));
+  }
+  if(ready.empty())
+    return false;
+
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  for(auto& i:ready) {
+    try {
+      auto t = inst->dev.texture(i.pm);
+      inst->recycled[inst->recycledId].tex.emplace_back(std::move(*i.dst));
+      *i.dst = std::move(t);
+      }
+    catch(...) {
+      }
+    }
+  return true;
+  }
+
 const Texture2d* Resources::loadTexture(Tempest::Color color) {
   if(color==Color())
     return nullptr;
@@ -832,7 +1124,6 @@ Material Resources::loadMaterial(const zenkit::Material& src, bool enableAlphaTe
 const ProtoMesh* Resources::loadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadMesh(name);
   }
 
@@ -851,17 +1142,20 @@ const Skeleton* Resources::loadSkeleton(std::string_view name) {
   }
 
 const Animation* Resources::loadAnimation(std::string_view name) {
-  auto cname = std::string(name);
-
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  auto  cname = std::string(name);
   auto& cache = inst->animCache;
+  {
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
   auto it=cache.find(cname);
   if(it!=cache.end())
     return it->second.get();
-  auto t       = inst->implLoadAnimation(cname);
-  auto ret     = t.get();
-  cache[cname] = std::move(t);
-  return ret;
+  }
+
+  auto t = inst->implLoadAnimation(cname);
+
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  auto it = cache.try_emplace(cname,std::move(t)).first;
+  return it->second.get();
   }
 
 Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
@@ -894,6 +1188,7 @@ void Resources::resetRecycled(uint8_t fId) {
   inst->recycledId = fId;
   inst->recycled[fId].ds.clear();
   inst->recycled[fId].ssbo.clear();
+  inst->recycled[fId].tex.clear();
   }
 
 void Resources::recycle(Tempest::DescriptorSet&& ds) {
@@ -2,6 +2,7 @@
 
 #include <Tempest/Font>
 #include <Tempest/Texture2d>
+#include <Tempest/Pixmap>
 #include <Tempest/Device>
 #include <Tempest/SoundDevice>
 
@@ -9,11 +10,15 @@
 #include <zenkit/world/VobTree.hh>
 
 #include <tuple>
+#include <span>
 #include <string_view>
 #include <map>
 
 #include "graphics/material.h"
 #include "sound/soundfx.h"
+#include "utils/workers.h"
+#include "utils/assetcache.h"
+#include "utils/mappedfile.h"
 
 struct DmSegment;
 struct DmLoader;
@@ -95,6 +100,9 @@ class Resources final {
     static const Tempest::Texture2d& fallbackTexture();
     static const Tempest::Texture2d& fallbackBlack();
     static const Tempest::Texture2d* loadTexture(std::string_view name);
+    static const Tempest::Texture2d* loadTextureAsync(std::string_view name);
+    static bool                      hasTexturesReady();
+    static bool                      commitTextures();
     static const Tempest::Texture2d* loadTexture(Tempest::Color color);
     static const Tempest::Texture2d* loadTexture(std::string_view name, int32_t v, int32_t c);
     static       Tempest::Texture2d  loadTexturePm(const Tempest::Pixmap& pm);
@@ -140,9 +148,11 @@ class Resources final {
     static std::vector<uint8_t>      getFileData(std::string_view name);
     static bool                      getFileData(std::string_view name, std::vector<uint8_t>& dat);
     static std::unique_ptr<zenkit::Read> getFileBuffer(std::string_view name);
+    static std::span<const uint8_t>  getFileView(std::string_view name);
     static bool                      hasFile    (std::string_view fname);
 
     static const zenkit::Vfs&        vdfsIndex();
+    static const AssetCache&         assetCache();
 
     static const Tempest::VertexBuffer<VertexFsq>& fsqVbo();
 
@@ -169,13 +179,26 @@ class Resources final {
         }
       };
 
+    enum {
+      MaxTexUploadsPerCommit = 256,
+      };
+
+    struct TexUpload {
+      Tempest::Texture2d* dst = nullptr;
+      Tempest::Pixmap     pm;
+      };
+
     using TextureCache = std::unordered_map<std::string,std::unique_ptr<Tempest::Texture2d>>;
 
     int64_t               vdfTimestamp(const std::u16string& name);
     void                  detectVdf(std::vector<Archive>& ret, const std::u16string& root);
+    void                  mountVdf(const Archive& a);
 
     Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string_view cname);
     Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string &&name, zenkit::Read& data);
+    Tempest::Texture2d*   implLoadTextureAsync(std::string_view cname);
+    Tempest::Texture2d    mkPlaceholder(const zenkit::VfsNode& entry, bool compiled);
+    static bool           decodeTexture(const zenkit::VfsNode& entry, std::string_view name, bool compiled, Tempest::Pixmap& out);
     ProtoMesh*            implLoadMesh(std::string_view name);
     std::unique_ptr<ProtoMesh> implLoadMeshMain(std::string name);
     std::unique_ptr<Animation> implLoadAnimation(std::string name);
@@ -222,13 +245,18 @@ class Resources final {
     std::unique_ptr<Dx8::DirectMusic> dxMusic;
     DmLoader*                         dmLoader = nullptr;
     zenkit::Vfs                       gothicAssets;
+    AssetCache                        trCache;
+
+    // archives are mapped once; nodes of gothicAssets, that came from an archive, point directly into the mapping
+    std::vector<MappedFile>                  vdfMaps;
+    std::unordered_map<const zenkit::VfsNode*,std::span<const uint8_t>> vdfNodes;
 
-    std::vector<uint8_t>              fBuff, ddsBuf;
     Tempest::VertexBuffer<VertexFsq>  fsq;
 
     struct DeleteQueue {
       std::vector<Tempest::DescriptorSet> ds;
       std::vector<Tempest::StorageBuffer> ssbo;
+      std::vector<Tempest::Texture2d>     tex;
       };
     DeleteQueue recycled[MaxFramesInFlight];
     uint8_t     recycledId = 0;
@@ -245,4 +273,9 @@ class Resources final {
 
     std::recursive_mutex                                              syncFont;
     std::unordered_map<FontK,std::unique_ptr<GthFont>,Hash>           gothicFnt;
+
+    // background texture decoding; decoded images are uploaded by commitTextures
+    std::mutex                                                        syncTex;
+    std::vector<TexUpload>                                            texReady;
+    Workers::TaskGroup                                                texDecode;
   };
@@ -1005,10 +1005,10 @@ void GameMenu::updateSavTitle(GameMenu::Item& sel) {
       sel.handle->text[0] = hdr.name;
     sel.savHdr = std::move(hdr);
 
-    if(reader.setEntry("priview.png"))
-      reader.read(sel.savPriview); // legacy
-    else if(reader.setEntry("preview.png"))
+    if(reader.setEntry("preview.png"))
       reader.read(sel.savPriview);
+    else if(reader.setEntry("priview.png"))
+      reader.read(sel.savPriview); // legacy
     }
   catch(std::bad_alloc&) {
     return;
@@ -0,0 +1,156 @@
+#include "assetcache.h"
+
+#include <Tempest/TextCodec>
+#include <Tempest/Log>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <cstdio>
+
+using namespace Tempest;
+
+void AssetCache::Writer::append(const void* p, size_t sz) {
+  auto b = reinterpret_cast<const uint8_t*>(p);
+  buf.insert(buf.end(), b, b+sz);
+  }
+
+void AssetCache::Reader::read(std::string& s) {
+  uint32_t sz = 0;
+  read(sz);
+  if(!ok || remain()<sz) {
+    ok = false;
+    return;
+    }
+  s.assign(reinterpret_cast<const char*>(at), sz);
+  at += sz;
+  }
+
+std::span<const uint8_t> AssetCache::Reader::readBytes() {
+  uint32_t sz = 0;
+  read(sz);
+  if(!ok || remain()<sz) {
+    ok = false;
+    return {};
+    }
+  auto ret = std::span<const uint8_t>(at, sz);
+  at += sz;
+  return ret;
+  }
+
+void AssetCache::Reader::take(void* p, size_t sz) {
+  if(!ok || remain()<sz) {
+    ok = false;
+    return;
+    }
+  std::memcpy(p, at, sz);
+  at += sz;
+  }
+
+void AssetCache::writeTexture(Writer& w, const TextureBlob& tex) {
+  w.write(tex.type);
+  w.write(tex.width);
+  w.write(tex.height);
+  w.writeBytes(tex.data);
+  }
+
+bool AssetCache::readTexture(Reader& r, TextureBlob& tex) {
+  r.read(tex.type);
+  r.read(tex.width);
+  r.read(tex.height);
+  tex.data = r.readBytes();
+  if(!r.isOk() || r.remain()!=0)
+    return false;
+  if(tex.type==TextureBlob::Dds)
+    return tex.data.size()>4 && std::memcmp(tex.data.data(),"DDS ",4)==0;
+  if(tex.type==TextureBlob::Rgba)
+    return tex.data.size()==size_t(tex.width)*size_t(tex.height)*4;
+  return false;
+  }
+
+void AssetCache::setup(std::u16string r, uint64_t fp) {
+  root        = std::move(r);
+  fingerprint = fp;
+  if(fingerprint==0)
+    return;
+  try {
+    std::filesystem::create_directories(std::filesystem::path(root));
+    }
+  catch(...) {
+    Log::e("unable to create asset cache directory: \"", TextCodec::toUtf8(root), "\"");
+    fingerprint = 0;
+    }
+  }
+
+std::u16string AssetCache::path(Kind k, std::string_view name) const {
+  uint64_t h = hash(&k, sizeof(k));
+  h = hash(name.data(), name.size(), h);
+  char buf[32] = {};
+  std::snprintf(buf, sizeof(buf), "%016llx.bin", static_cast<unsigned long long>(h));
+  return root + TextCodec::toUtf16(buf);
+  }
+
+bool AssetCache::load(Kind k, std::string_view name, Reader& out) const {
+  out.ok = false;
+  if(!isEnabled())
+    return false;
+  if(!out.file.open(path(k,name)))
+    return false;
+
+  out.at  = out.file.data();
+  out.end = out.file.data() + out.file.size();
+  out.ok  = true;
+
+  Header hdr;
+  out.read(hdr);
+  if(!out.ok || hdr.magic!=Magic || hdr.version!=FileVersion || hdr.fingerprint!=fingerprint ||
+     hdr.kind!=k || hdr.nameLen!=name.size() || out.remain()<hdr.nameLen) {
+    out.ok = false;
+    return false;
+    }
+  if(std::memcmp(out.at, name.data(), name.size())!=0) {
+    // hash collision
+    out.ok = false;
+    return false;
+    }
+  out.at += hdr.nameLen;
+  if(out.remain()!=hdr.payload) {
+    out.ok = false;
+    return false;
+    }
+  return true;
+  }
+
+void AssetCache::save(Kind k, std::string_view name, const Writer& w) const {
+  if(!isEnabled())
+    return;
+
+  Header hdr;
+  hdr.fingerprint = fingerprint;
+  hdr.kind        = k;
+  hdr.nameLen     = uint32_t(name.size());
+  hdr.payload     = w.data().size();
+
+  char suffix[32] = {};
+  std::snprintf(suffix, sizeof(suffix), ".%zx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+  const auto dst = std::filesystem::path(path(k,name));
+  auto       tmp = dst;
+  tmp += suffix;
+  try {
+    {
+    std::ofstream fout(tmp, std::ios::binary | std::ios::trunc);
+    fout.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    fout.write(name.data(), std::streamsize(name.size()));
+    fout.write(reinterpret_cast<const char*>(w.data().data()), std::streamsize(w.data().size()));
+    if(!fout)
+      throw std::runtime_error("write error");
+    }
+    // concurrent writers of same asset produce identical data; rename is atomic
+    std::filesystem::rename(tmp, dst);
+    }
+  catch(...) {
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    }
+  }
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <cstring>
+#include <type_traits>
+
+#include "mappedfile.h"
+
+// persistent cache of transcoded assets: one file per asset, invalidated by archive-set fingerprint
+class AssetCache final {
+  public:
+    enum Kind : uint8_t {
+      K_Texture,
+      K_Mesh,
+      K_Animation,
+      K_Waynet,
+      };
+
+    class Writer final {
+      public:
+        template<class T>
+        void write(const T& v) {
+          static_assert(std::is_trivially_copyable<T>::value);
+          append(&v,sizeof(T));
+          }
+        template<class T>
+        void write(const std::vector<T>& v) {
+          static_assert(std::is_trivially_copyable<T>::value);
+          write(uint32_t(v.size()));
+          append(v.data(),v.size()*sizeof(T));
+          }
+        void write(std::string_view s) {
+          write(uint32_t(s.size()));
+          append(s.data(),s.size());
+          }
+        void write(const std::string& s) { write(std::string_view(s)); }
+        void writeBytes(std::span<const uint8_t> b) {
+          write(uint32_t(b.size()));
+          append(b.data(),b.size());
+          }
+
+        const std::vector<uint8_t>& data() const { return buf; }
+
+      private:
+        void append(const void* p, size_t sz);
+        std::vector<uint8_t> buf;
+      };
+
+    class Reader final {
+      public:
+        template<class T>
+        void read(T& v) {
+          static_assert(std::is_trivially_copyable<T>::value);
+          take(&v,sizeof(T));
+          }
+        template<class T>
+        void read(std::vector<T>& v) {
+          static_assert(std::is_trivially_copyable<T>::value);
+          uint32_t sz = 0;
+          read(sz);
+          if(!ok || size_t(end-at)/sizeof(T)<sz) {
+            ok = false;
+            return;
+            }
+          v.resize(sz);
+          take(v.data(),sz*sizeof(T));
+          }
+        void read(std::string& s);
+        // length-prefixed array from Writer::writeBytes or Writer::write(std::vector), without copy
+        auto readBytes() -> std::span<const uint8_t>;
+
+        bool           isOk()   const { return ok; }
+        const uint8_t* data()   const { return at; }
+        size_t         remain() const { return size_t(end-at); }
+
+      private:
+        void take(void* p, size_t sz);
+
+        MappedFile     file;
+        const uint8_t* at  = nullptr;
+        const uint8_t* end = nullptr;
+        bool           ok  = false;
+      friend class AssetCache;
+      };
+
+    // K_Texture payload: DDS file or raw RGBA8 pixels
+    struct TextureBlob final {
+      enum Type : uint8_t {
+        Dds  = 0,
+        Rgba = 1,
+        };
+      uint8_t                  type   = Dds;
+      uint32_t                 width  = 0;
+      uint32_t                 height = 0;
+      std::span<const uint8_t> data;
+      };
+
+    AssetCache() = default;
+
+    void setup(std::u16string root, uint64_t fingerprint);
+    bool isEnabled() const { return fingerprint!=0; }
+
+    bool load(Kind k, std::string_view name, Reader& out) const;
+    void save(Kind k, std::string_view name, const Writer& w) const;
+
+    static void     writeTexture(Writer& w, const TextureBlob& tex);
+    static bool     readTexture (Reader& r, TextureBlob& tex);
+
+  private:
+    enum : uint32_t {
+      Magic       = 0x4341474F, // "OGAC"
+      FileVersion = 3,
+      };
+
+    struct Header {
+      uint32_t magic       = Magic;
+      uint32_t version     = FileVersion;
+      uint64_t fingerprint = 0;
+      uint32_t kind        = 0;
+      uint32_t nameLen     = 0;
+      uint64_t payload     = 0;
+      };
+
+    std::u16string path(Kind k, std::string_view name) const;
+
+    std::u16string root;
+    uint64_t       fingerprint = 0;
+  };
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// 64-bit FNV-1a: stable across runs and platforms, unlike std::hash; fine for cache keys and seeds
+namespace Fnv {
+  inline constexpr uint64_t Basis = 0xcbf29ce484222325ull;
+  inline constexpr uint64_t Prime = 0x100000001b3ull;
+
+  inline uint64_t hash(const void* data, size_t sz, uint64_t h = Basis) {
+    auto b = reinterpret_cast<const uint8_t*>(data);
+    for(size_t i=0; i<sz; ++i) {
+      h ^= b[i];
+      h *= Prime;
+      }
+    return h;
+    }
+  }
@@ -0,0 +1,114 @@
+#include "mappedfile.h"
+
+#include <Tempest/TextCodec>
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+  }
+
+MappedFile::~MappedFile() {
+  close();
+  }
+
+MappedFile& MappedFile::operator = (MappedFile&& other) noexcept {
+  if(this==&other)
+    return *this;
+  close();
+  std::swap(ptr,other.ptr);
+  std::swap(sz, other.sz);
+#ifdef __WINDOWS__
+  std::swap(hFile,other.hFile);
+  std::swap(hMap, other.hMap);
+#endif
+  return *this;
+  }
+
+#ifdef __WINDOWS__
+bool MappedFile::open(const std::u16string& path) {
+  close();
+  HANDLE f = CreateFileW(reinterpret_cast<const WCHAR*>(path.c_str()), GENERIC_READ, FILE_SHARE_READ,
+                         nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(f==INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER fsz = {};
+  if(!GetFileSizeEx(f,&fsz) || fsz.QuadPart<=0) {
+    CloseHandle(f);
+    return false;
+    }
+
+  HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(m==nullptr) {
+    CloseHandle(f);
+    return false;
+    }
+
+  void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+  if(view==nullptr) {
+    CloseHandle(m);
+    CloseHandle(f);
+    return false;
+    }
+
+  hFile = f;
+  hMap  = m;
+  ptr   = reinterpret_cast<const uint8_t*>(view);
+  sz    = size_t(fsz.QuadPart);
+  return true;
+  }
+
+void MappedFile::close() {
+  if(ptr!=nullptr)
+    UnmapViewOfFile(ptr);
+  if(hMap!=nullptr)
+    CloseHandle(hMap);
+  if(hFile!=nullptr)
+    CloseHandle(hFile);
+  ptr   = nullptr;
+  sz    = 0;
+  hMap  = nullptr;
+  hFile = nullptr;
+  }
+#else
+bool MappedFile::open(const std::u16string& path) {
+  close();
+  std::string p = Tempest::TextCodec::toUtf8(path);
+  int fd = ::open(p.c_str(), O_RDONLY);
+  if(fd<0)
+    return false;
+
+  struct stat st = {};
+  if(fstat(fd,&st)!=0 || st.st_size<=0) {
+    ::close(fd);
+    return false;
+    }
+
+  void* view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // mapping stays valid after descriptor is closed
+  ::close(fd);
+  if(view==MAP_FAILED)
+    return false;
+
+  ptr = reinterpret_cast<const uint8_t*>(view);
+  sz  = size_t(st.st_size);
+  return true;
+  }
+
+void MappedFile::close() {
+  if(ptr!=nullptr)
+    munmap(const_cast<uint8_t*>(ptr), sz);
+  ptr = nullptr;
+  sz  = 0;
+  }
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Tempest/Platform>
+
+#include <string>
+#include <cstdint>
+
+// read-only memory mapped file
+class MappedFile final {
+  public:
+    MappedFile() = default;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    ~MappedFile();
+
+    MappedFile& operator = (MappedFile&& other) noexcept;
+
+    bool           open(const std::u16string& path);
+    void           close();
+
+    bool           isOpen() const { return ptr!=nullptr; }
+    const uint8_t* data()   const { return ptr; }
+    size_t         size()   const { return sz;  }
+
+  private:
+    const uint8_t* ptr  = nullptr;
+    size_t         sz   = 0;
+#ifdef __WINDOWS__
+    void*          hFile = nullptr;
+    void*          hMap  = nullptr;
+#endif
+  };
@@ -0,0 +1,199 @@
+#include "profiler.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace Tempest;
+
+std::atomic_bool Profiler::enabled{false};
+
+struct Profiler::Thread {
+  static constexpr size_t Capacity = 1 << 16;
+
+  uint32_t                 id = 0;
+  std::atomic_bool         owned{true};
+  // uncontended, except while frame or dumpTrace copy events out
+  std::mutex               sync;
+  std::unique_ptr<Event[]> ring{new Event[Capacity]};
+  uint64_t                 head = 0;
+  uint64_t                 tail = 0;
+
+  void copy(uint64_t from, std::vector<Event>& out) {
+    from = std::max(from, head>Capacity ? head-Capacity : 0);
+    for(uint64_t i=from; i<head; ++i)
+      out.push_back(ring[i%Capacity]);
+    }
+  };
+
+struct Profiler::Registry {
+  std::mutex                             sync;
+  std::vector<std::unique_ptr<Thread>>   threads;
+  std::unordered_map<const char*,Stat>   stat;
+  uint32_t                               nextId = 0;
+  };
+
+Profiler::Registry& Profiler::registry() {
+  static Registry r;
+  return r;
+  }
+
+void Profiler::setEnabled(bool e) {
+  enabled.store(e);
+  if(e)
+    return;
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+  r.stat.clear();
+  }
+
+uint64_t Profiler::timestamp() {
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+  }
+
+Profiler::Thread& Profiler::thread() {
+  struct Local {
+    Thread* t = nullptr;
+    ~Local() {
+      if(t!=nullptr)
+        t->owned.store(false);
+      }
+    };
+  static thread_local Local local;
+  if(local.t!=nullptr)
+    return *local.t;
+
+  // ring of finished thread (loader, etc.) is reused, with events of new thread only
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+  for(auto& i:r.threads) {
+    bool owned = false;
+    if(i->owned.compare_exchange_strong(owned,true)) {
+      std::lock_guard<std::mutex> lck(i->sync);
+      i->id   = r.nextId++;
+      i->head = 0;
+      i->tail = 0;
+      local.t = i.get();
+      return *local.t;
+      }
+    }
+  r.threads.emplace_back(std::make_unique<Thread>());
+  local.t     = r.threads.back().get();
+  local.t->id = r.nextId++;
+  return *local.t;
+  }
+
+void Profiler::push(const char* name, uint64_t begin) {
+  auto&       t = thread();
+  const Event e = {name,begin,timestamp()};
+  std::lock_guard<std::mutex> guard(t.sync);
+  t.ring[t.head%Thread::Capacity] = e;
+  t.head++;
+  }
+
+void Profiler::frame() {
+  if(!isEnabled())
+    return;
+
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+
+  std::vector<Event> ev;
+  for(auto& t:r.threads) {
+    std::lock_guard<std::mutex> lck(t->sync);
+    t->copy(t->tail,ev);
+    t->tail = t->head;
+    }
+
+  std::unordered_map<const char*,Stat> cur;
+  for(auto& e:ev) {
+    auto& s = cur[e.name];
+    s.name   = e.name;
+    s.time  += double(e.end-e.begin)/1000000.0;
+    s.count += 1;
+    }
+
+  static const double k = 0.1;
+  for(auto& [name,s]:r.stat) {
+    auto it = cur.find(name);
+    if(it==cur.end()) {
+      s.time  = s.time *(1.0-k);
+      s.count = s.count*(1.0-k);
+      continue;
+      }
+    s.time  = s.time *(1.0-k) + it->second.time *k;
+    s.count = s.count*(1.0-k) + it->second.count*k;
+    cur.erase(it);
+    }
+  for(auto& [name,s]:cur)
+    r.stat[name] = s;
+  }
+
+auto Profiler::top(size_t n) -> std::vector<Stat> {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+
+  std::vector<Stat> ret;
+  ret.reserve(r.stat.size());
+  for(auto& [name,s]:r.stat)
+    ret.push_back(s);
+  std::sort(ret.begin(),ret.end(),[](const Stat& a, const Stat& b){ return a.time>b.time; });
+  if(ret.size()>n)
+    ret.resize(n);
+  return ret;
+  }
+
+bool Profiler::dumpTrace(const std::string& file) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+
+  // copy out, so that threads are blocked only for a memcpy
+  std::vector<std::vector<Event>> ev(r.threads.size());
+  std::vector<uint32_t>           tid(r.threads.size());
+  uint64_t                        epoch = uint64_t(-1);
+  for(size_t i=0; i<r.threads.size(); ++i) {
+    auto& t = *r.threads[i];
+    {
+    std::lock_guard<std::mutex> lck(t.sync);
+    t.copy(0,ev[i]);
+    tid[i] = t.id;
+    }
+    for(auto& e:ev[i])
+      epoch = std::min(epoch,e.begin);
+    }
+
+  try {
+    WFile fout(file.c_str());
+    char  buf[256] = {};
+    bool  first    = true;
+
+    const char* hdr = "{\"traceEvents\":[\n";
+    fout.write(hdr,std::strlen(hdr));
+    for(size_t i=0; i<ev.size(); ++i) {
+      for(auto& e:ev[i]) {
+        // NOTE: zone names are string literals - no escaping
+        int len = std::snprintf(buf,sizeof(buf),"%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                first ? "" : ",\n", e.name, tid[i],
+                                double(e.begin-epoch)/1000.0, double(e.end-e.begin)/1000.0);
+        if(len>0)
+          fout.write(buf,std::min(size_t(len),sizeof(buf)-1));
+        first = false;
+        }
+      }
+    const char* end = "\n]}\n";
+    fout.write(end,std::strlen(end));
+    }
+  catch(...) {
+    Log::e("unable to write profiler trace: \"",file,"\"");
+    return false;
+    }
+  return true;
+  }
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// scoped-zone cpu profiler: per-thread ring buffers, single relaxed load when disabled
+class Profiler final {
+  public:
+    class Zone final {
+      public:
+        explicit Zone(const char* name) {
+          if(Profiler::isEnabled()) {
+            this->name = name;
+            this->time = Profiler::timestamp();
+            }
+          }
+        Zone(const Zone&) = delete;
+        ~Zone() {
+          if(name!=nullptr)
+            Profiler::push(name,time);
+          }
+
+      private:
+        const char* name = nullptr;
+        uint64_t    time = 0;
+      };
+
+    struct Stat {
+      const char* name  = nullptr;
+      double      time  = 0; // ms per frame, smoothed
+      double      count = 0; // calls per frame, smoothed
+      };
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool e);
+
+    // collects zones of last frame; to be called once per frame from main thread
+    static void frame();
+    static auto top(size_t n) -> std::vector<Stat>;
+
+    // Chrome trace_event json, with zones currently kept in ring buffers
+    static bool dumpTrace(const std::string& file);
+
+  private:
+    struct Event {
+      const char* name;
+      uint64_t    begin;
+      uint64_t    end;
+      };
+    struct Thread;
+    struct Registry;
+
+    static uint64_t  timestamp();
+    static void      push(const char* name, uint64_t begin);
+    static Thread&   thread();
+    static Registry& registry();
+
+    static std::atomic_bool enabled;
+  };
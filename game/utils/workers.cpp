@@ -63,21 +63,28 @@ using namespace Tempest;
 const size_t Workers::taskPerThread = 128;
 const size_t Workers::taskPerStep   = 16;
 
+// 0 - shared queue for non-worker threads (main, loading), 1..N - per-worker deques
+static thread_local size_t localQueue = 0;
+
 Workers::Workers() {
-  size_t id=0;
-  for(auto& i:th) {
-    i = std::thread([this,id]() noexcept {
+  const size_t thCount = maxThreads();
+  queueCount = thCount+1;
+  queues.reset(new Queue[queueCount]);
+
+  th.resize(thCount);
+  for(size_t id=0; id<th.size(); ++id) {
+    th[id] = std::thread([this,id]() noexcept {
       threadFunc(id);
       });
-    ++id;
     }
   }
 
 Workers::~Workers() {
-  running  = false;
-  workSet  = nullptr;
-  workSize = MAX_THREADS;
-  execWork(minWorkSize<void,void>());
+  {
+  std::unique_lock<std::mutex> lck(sync);
+  running.store(false);
+  }
+  workWait.notify_all();
   for(auto& i:th)
     i.join();
   }
@@ -87,13 +94,13 @@ Workers &Workers::inst() {
   return w;
   }
 
-uint8_t Workers::maxThreads() {
+uint32_t Workers::maxThreads() {
   int32_t th = int32_t(std::thread::hardware_concurrency());
+  // one core is left for caller thread, that also participates in work
+  th -= 1;
   if(th<=0)
     th = 1;
-  if(th>MAX_THREADS)
-    return MAX_THREADS;
-  return uint8_t(th);
+  return uint32_t(th);
   }
 
 void Workers::threadFunc(size_t id) {
@@ -102,98 +109,153 @@ void Workers::threadFunc(size_t id) {
   setThreadName(tname.c_str());
   }
 
+  localQueue = id+1;
   while(true) {
-    {
+    if(tryRunOne())
+      continue;
+
     std::unique_lock<std::mutex> lck(sync);
-    workWait.wait(lck, [this]() { return workTbd>0; });
-    --workTbd;
+    sleeping.fetch_add(1);
+    workWait.wait(lck, [this]() { return !running.load() || queued.load()>0; });
+    sleeping.fetch_sub(1);
+    if(!running.load() && queued.load()<=0)
+      return;
     }
+  }
 
-    if(!running) {
-      taskDone.fetch_add(1);
-      return;
-      }
+void Workers::submit(TaskGroup& group, std::function<void()>&& fn) {
+  group.pending.fetch_add(1);
 
-    if(workSet==nullptr) {
-      auto idx = progressIt.fetch_add(1);
-      workFunc(workSet+idx, 1);
-      } else {
-      taskLoop();
-      }
+  auto& q = queues[localQueue];
+  {
+  std::lock_guard<std::mutex> guard(q.sync);
+  q.tasks.push_back(Task{std::move(fn), &group});
+  }
 
-    taskDone.fetch_add(1);
-    // if(size_t(taskDone.fetch_add(1)+1)==taskCount)
-    //   std::this_thread::yield();
+  queued.fetch_add(1);
+  if(sleeping.load()>0) {
+    // lock is required to not miss a worker that is about to sleep
+    std::lock_guard<std::mutex> guard(sync);
+    workWait.notify_one();
     }
   }
 
-uint32_t Workers::taskLoop() {
-  uint32_t count = 0;
-  while(true) {
-    size_t b = size_t(progressIt.fetch_add(taskPerStep));
-    size_t e = std::min(b+taskPerStep, workSize);
-    if(e<=b)
-      break;
-
-    void* d = workSet + b*workEltSize;
-    workFunc(d,e-b);
-    count += uint32_t(e-b);
-    }
-  return count;
+bool Workers::pop(size_t qId, Task& out) {
+  auto& q = queues[qId];
+  std::lock_guard<std::mutex> guard(q.sync);
+  if(q.tasks.empty())
+    return false;
+  out = std::move(q.tasks.back());
+  q.tasks.pop_back();
+  return true;
   }
 
-void Workers::execWork(uint32_t& minElts) {
-  if(workSize==0)
-    return;
+bool Workers::steal(size_t qId, Task& out) {
+  auto& q = queues[qId];
+  std::unique_lock<std::mutex> guard(q.sync, std::try_to_lock);
+  if(!guard.owns_lock() || q.tasks.empty())
+    return false;
+  out = std::move(q.tasks.front());
+  q.tasks.pop_front();
+  return true;
+  }
 
-  if(workSet!=nullptr) {
-    const auto maxTheads = maxThreads();
-    taskCount = uint32_t((workSize+taskPerThread-1)/taskPerThread);
-    taskCount--; // main thread also do tasks
-    if(taskCount>maxTheads)
-      taskCount = maxTheads;
-    if(taskCount<=0)
-      taskCount = 1;
-    } else {
-    taskCount = uint32_t(workSize);
-    }
+bool Workers::tryRunOne() {
+  if(queued.load()<=0)
+    return false;
 
-  if(running && taskCount==1) {
-    workFunc(workSet, workSize);
-    return;
+  const size_t self = localQueue;
+  Task         t;
+  if(pop(self,t)) {
+    exec(t);
+    return true;
     }
 
-  minElts = std::max<uint32_t>(minElts, taskPerThread);
+  for(size_t i=1; i<queueCount; ++i) {
+    const size_t victim = (self+i)%queueCount;
+    if(steal(victim,t)) {
+      exec(t);
+      return true;
+      }
+    }
+  return false;
+  }
 
-  if(workSet!=nullptr && workSize<=minElts && true) {
-    workFunc(workSet, workSize);
-    if(minElts > workSize*2)
-      minElts = 0;
-    return;
+bool Workers::take(size_t qId, const TaskGroup& g, Task& out) {
+  auto& q = queues[qId];
+  std::lock_guard<std::mutex> guard(q.sync);
+  for(auto i=q.tasks.rbegin(); i!=q.tasks.rend(); ++i) {
+    if(i->group!=&g)
+      continue;
+    out = std::move(*i);
+    q.tasks.erase(std::next(i).base());
+    return true;
     }
+  return false;
+  }
 
-  progressIt.store(0);
-  taskDone.store(0);
+bool Workers::tryRunGroup(const TaskGroup& g) {
+  if(queued.load()<=0)
+    return false;
 
-  {
-  std::unique_lock<std::mutex> lck(sync);
-  workTbd = int32_t(taskCount);
+  const size_t self = localQueue;
+  Task         t;
+  for(size_t i=0; i<queueCount; ++i) {
+    if(take((self+i)%queueCount,g,t)) {
+      exec(t);
+      return true;
+      }
+    }
+  return false;
   }
-  workWait.notify_all();
 
-  uint32_t cnt = 0;
-  if(workSet==nullptr) {
-    std::this_thread::yield();
-    } else {
-    cnt = taskLoop(); (void)cnt;
+void Workers::exec(Task& t) {
+  queued.fetch_sub(1);
+  std::exception_ptr err;
+  try {
+    t.fn();
     }
+  catch(...) {
+    err = std::current_exception();
+    }
+  t.group->finish(err);
+  }
 
-  while(true) {
-    int expect = int(taskCount);
-    if(taskDone.load()==expect) {
-      taskDone.store(0);
-      break;
-      }
+void Workers::TaskGroup::finish(std::exception_ptr err) {
+  // under lock: waiter may destroy the group, as soon as pending is zero
+  std::lock_guard<std::mutex> guard(sync);
+  if(err!=nullptr && error==nullptr)
+    error = err;
+  if(pending.fetch_sub(1)==1)
+    done.notify_all();
+  }
+
+void Workers::TaskGroup::implWait() {
+  auto& w = Workers::inst();
+  // help only with own tasks: a render-thread wait must not pick up unrelated long jobs
+  for(int spin=0; pending.load()>0 && spin<64; ) {
+    if(w.tryRunGroup(*this))
+      continue;
     std::this_thread::yield();
+    ++spin;
+    }
+  std::unique_lock<std::mutex> lck(sync);
+  while(pending.load()>0) {
+    lck.unlock();
+    const bool ran = w.tryRunGroup(*this);
+    lck.lock();
+    if(!ran && pending.load()>0)
+      done.wait(lck);
     }
   }
+
+void Workers::TaskGroup::wait() {
+  implWait();
+  std::exception_ptr err;
+  {
+  std::lock_guard<std::mutex> guard(sync);
+  std::swap(err,error);
+  }
+  if(err!=nullptr)
+    std::rethrow_exception(err);
+  }
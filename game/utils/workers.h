@@ -3,10 +3,13 @@
 #include <thread>
 #include <mutex>
 #include <vector>
+#include <deque>
+#include <memory>
 #include <functional>
 #include <atomic>
 #include <algorithm>
 #include <condition_variable>
+#include <exception>
 #include <new>
 
 class Workers final {
@@ -14,87 +17,118 @@ class Workers final {
     Workers();
     ~Workers();
 
+    class TaskGroup final {
+      public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        ~TaskGroup() { implWait(); }
+
+        template<class F>
+        void run(F&& func) {
+          Workers::inst().submit(*this, std::function<void()>(std::forward<F>(func)));
+          }
+        // rethrows first exception, thrown by a task of this group
+        void wait();
+
+      private:
+        void implWait();
+        void finish(std::exception_ptr err);
+
+        std::atomic<int32_t>    pending{0};
+        std::mutex              sync;
+        std::condition_variable done;
+        std::exception_ptr      error;
+      friend class Workers;
+      };
+
     static void setThreadName(const char* threadName);
 
     template<class T,class F>
     static void parallelFor(T* b, T* e, const F& func) {
-      inst().runParallelFor(b,std::distance(b,e),func);
+      runParallelFor(b,size_t(std::distance(b,e)),func);
       }
 
     template<class T,class F>
     static void parallelFor(std::vector<T>& data, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),func);
+      runParallelFor(data.data(),data.size(),func);
       }
 
     template<class T,class F>
     static void parallelTasks(std::vector<T>& data, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),func);
+      runParallelFor(data.data(),data.size(),func);
       }
 
     template<class F>
     static void parallelTasks(size_t taskCount, const F& func) {
-      inst().runParallelTasks<F>(taskCount,func);
+      runParallelTasks<F>(taskCount,func);
       }
 
-    static uint8_t maxThreads();
+    static uint32_t maxThreads();
 
   private:
-    enum { MAX_THREADS=16 };
+    struct Task {
+      std::function<void()> fn;
+      TaskGroup*            group = nullptr;
+      };
+
+    struct alignas(64) Queue {
+      std::mutex       sync;
+      std::deque<Task> tasks;
+      };
 
     void            threadFunc(size_t id);
-    void            execWork(uint32_t& minWorkSize);
-    uint32_t        taskLoop();
+    void            submit(TaskGroup& group, std::function<void()>&& fn);
+    bool            tryRunOne();
+    bool            tryRunGroup(const TaskGroup& g);
+    bool            pop(size_t qId, Task& out);
+    bool            steal(size_t qId, Task& out);
+    bool            take(size_t qId, const TaskGroup& g, Task& out);
+    void            exec(Task& t);
     static Workers& inst();
 
     template<class T,class F>
-    static uint32_t&  minWorkSize() {
-      static uint32_t data = 0;
-      return data;
-      }
-
-
-    template<class T,class F>
-    void runParallelFor(T* data, size_t sz, const F& func) {
-      workSet     = reinterpret_cast<uint8_t*>(data);
-      workSize    = sz;
-      workEltSize = sizeof(T);
-
-      workFunc = [&func](void* data, size_t sz) {
-        T* tdata = reinterpret_cast<T*>(data);
-        for(size_t i=0;i<sz;++i)
-          func(tdata[i]);
-        };
-
-      execWork(minWorkSize<T,F>());
+    static void runParallelFor(T* data, size_t sz, const F& func) {
+      if(sz<=taskPerThread) {
+        for(size_t i=0; i<sz; ++i)
+          func(data[i]);
+        return;
+        }
+
+      const size_t grain = std::max(taskPerStep, sz/(size_t(maxThreads())*4));
+      TaskGroup    group;
+      for(size_t b=grain; b<sz; b+=grain) {
+        const size_t e = std::min(b+grain, sz);
+        group.run([data,b,e,&func]() {
+          for(size_t i=b; i<e; ++i)
+            func(data[i]);
+          });
+        }
+      for(size_t i=0; i<grain; ++i)
+        func(data[i]);
+      group.wait();
       }
 
     template<class F>
-    void runParallelTasks(size_t taskCount, const F& func) {
-      workSet     = nullptr;
-      workSize    = taskCount;
-      workEltSize = 1;
-
-      workFunc = [&func](void* data, size_t sz) {
-        func(reinterpret_cast<uintptr_t>(data));
-        };
-      execWork(minWorkSize<void,F>());
+    static void runParallelTasks(size_t taskCount, const F& func) {
+      if(taskCount==0)
+        return;
+      TaskGroup group;
+      for(size_t i=1; i<taskCount; ++i)
+        group.run([i,&func]() { func(i); });
+      func(size_t(0));
+      group.wait();
       }
 
     static const size_t               taskPerThread;
     static const size_t               taskPerStep;
-    bool                              running=true;
+    std::atomic_bool                  running{true};
 
-    std::thread                       th[MAX_THREADS];
+    std::vector<std::thread>          th;
+    std::unique_ptr<Queue[]>          queues;
+    size_t                            queueCount = 0;
 
     std::mutex                        sync;
     std::condition_variable           workWait;
-    int32_t                           workTbd = 0;
-
-    uint8_t*                          workSet=nullptr;
-    size_t                            workSize=0, workEltSize=0;
-    std::function<void(void*,size_t)> workFunc;
-
-    std::atomic_int                   progressIt{0};
-    uint32_t                          taskCount = 0;
-    std::atomic_int                   taskDone{0};
+    std::atomic<int32_t>              queued{0};
+    std::atomic<int32_t>              sleeping{0};
   };
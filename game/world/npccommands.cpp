@@ -0,0 +1,32 @@
+#include "npccommands.h"
+
+static thread_local NpcCommands* threadCmd = nullptr;
+
+NpcCommands::Scope::Scope(NpcCommands& cmd)
+  :prev(threadCmd) {
+  threadCmd = &cmd;
+  }
+
+NpcCommands::Scope::~Scope() {
+  threadCmd = prev;
+  }
+
+NpcCommands* NpcCommands::current() {
+  return threadCmd;
+  }
+
+void NpcCommands::exec(std::function<void()>&& fn) {
+  if(threadCmd!=nullptr)
+    threadCmd->push(std::move(fn)); else
+    fn();
+  }
+
+void NpcCommands::push(std::function<void()>&& fn) {
+  cmd.push_back(std::move(fn));
+  }
+
+void NpcCommands::replay() {
+  for(auto& i:cmd)
+    i();
+  cmd.clear();
+  }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+// effects of parallel npc tick on shared world state: perception, damage, item spawns and script calls
+// recorded per worker task and replayed afterwards in npc order, so result doesn't depend on scheduling
+class NpcCommands final {
+  public:
+    class Scope final {
+      public:
+        Scope(NpcCommands& cmd);
+        ~Scope();
+
+      private:
+        NpcCommands* prev = nullptr;
+      };
+
+    // buffer of current thread; nullptr outside of Scope
+    static NpcCommands* current();
+    // records 'fn' into buffer of current thread, or runs it right away
+    static void         exec(std::function<void()>&& fn);
+
+    void                push(std::function<void()>&& fn);
+    void                replay();
+
+  private:
+    std::vector<std::function<void()>> cmd;
+  };
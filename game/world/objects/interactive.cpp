@@ -60,7 +60,8 @@ Interactive::Interactive(Vob* parent, World &world, const zenkit::VMovableObject
     pickLockStr = door.pick_string;
     }
 
-  if(isContainer() && (flags&Flags::Startup)==Flags::Startup) {
+  // NOTE: filled regardless of Startup - unchanged containers are not stored in save-game, but restored from *.zen
+  if(isContainer()) {
     auto& container = reinterpret_cast<const zenkit::VContainer&>(vob);
     locked      = container.locked;
     keyInstance = container.key;
@@ -34,6 +34,8 @@ class Interactive : public Vob {
 
     void                resetPositionToTA(int32_t state);
     void                updateAnimation(uint64_t dt);
+    void                snapshot(RenderSnapshot& dst) { visual.snapshot(dst,this); }
+    void                setRenderPose(const Tempest::Matrix4x4* tr, size_t count) { visual.setRenderPose(tr,count); }
     void                tick(uint64_t dt);
     void                onKeyInput(KeyCodec::Action act);
 
@@ -6,6 +6,7 @@
 #include "game/gamescript.h"
 #include "world/objects/npc.h"
 #include "world/world.h"
+#include "graphics/rendersnapshot.h"
 #include "utils/fileext.h"
 
 using namespace Tempest;
@@ -121,6 +122,15 @@ void Item::setObjMatrix(const Tempest::Matrix4x4 &m) {
   view.setObjMatrix(m);
   }
 
+void Item::snapshot(RenderSnapshot& dst) {
+  dst.push(this,RenderSnapshot::T_Item,transform(),nullptr,0);
+  }
+
+void Item::setRenderPose(const Tempest::Matrix4x4* tr, size_t count) {
+  if(count>0)
+    view.setObjMatrix(tr[0]);
+  }
+
 bool Item::isMission() const {
   return (uint32_t(hitem->flags)&ITM_MISSION);
   }
@@ -316,5 +326,5 @@ void Item::moveEvent() {
   view  .setObjMatrix(transform());
   physic.setObjMatrix(transform());
   if(!isDynamic())
-    world.invalidateVobIndex();
+    world.updateVobIndex(*this);
   }
@@ -10,6 +10,7 @@
 class World;
 class Npc;
 class Serialize;
+class RenderSnapshot;
 
 class Item : public Vob {
   public:
@@ -35,6 +36,8 @@ class Item : public Vob {
     void    setPosition  (float x,float y,float z);
     void    setDirection (float x,float y,float z);
     void    setObjMatrix (const Tempest::Matrix4x4& m);
+    void    snapshot     (RenderSnapshot& dst);
+    void    setRenderPose(const Tempest::Matrix4x4* tr, size_t count);
 
     bool    isMission() const;
     bool    isEquipped() const { return equipped>0; }
@@ -71,6 +74,9 @@ class Item : public Vob {
     void                setCount(size_t cnt);
     size_t              count() const;
 
+    uint32_t            zenIndex() const { return zenId; }
+    void                setZenIndex(uint32_t id) { zenId = id; }
+
     std::string_view    uiText(size_t id) const;
     int32_t             uiValue(size_t id) const;
     int32_t             cost() const;
@@ -99,6 +105,7 @@ class Item : public Vob {
     uint32_t                       amount   = 0;
     uint8_t                        equipped = 0;
     uint8_t                        itSlot   = NSLOT;
+    uint32_t                       zenId    = uint32_t(-1);
 
     MeshObjects::Mesh              view;
     DynamicWorld::Item             physic;
@@ -12,8 +12,11 @@
 #include "world/objects/interactive.h"
 #include "world/objects/item.h"
 #include "world/world.h"
+#include "world/npccommands.h"
+#include "graphics/rendersnapshot.h"
 #include "utils/versioninfo.h"
 #include "utils/fileext.h"
+#include "utils/profiler.h"
 #include "camera.h"
 #include "gothic.h"
 #include "resources.h"
@@ -243,6 +246,7 @@ void Npc::load(Serialize &fin, size_t id) {
   fin.read(x,y,z,angle,sz);
   fin.read(wlkMode,trGuild,talentsSk,talentsVl,refuseTalkMilis);
   durtyTranform = TR_Pos|TR_Rot|TR_Scale;
+  owner.updateNpcIndex(*this);
 
   fin.read(permAttitude,tmpAttitude);
   fin.read(perceptionTime,perceptionNextTime);
@@ -364,6 +368,7 @@ bool Npc::setPosition(float ix, float iy, float iz) {
   z = iz;
   durtyTranform |= TR_Pos;
   physic.setPosition(Vec3{x,y,z});
+  owner.updateNpcIndex(*this);
   return true;
   }
 
@@ -376,6 +381,7 @@ void Npc::setViewPosition(const Tempest::Vec3& pos) {
   y = pos.y;
   z = pos.z;
   durtyTranform |= TR_Pos;
+  owner.updateNpcIndex(*this);
   }
 
 int Npc::aiOutputOrderId() const {
@@ -2074,24 +2080,41 @@ void Npc::tickRegen(int32_t& v, const int32_t max, const int32_t chg, const uint
   }
 
 void Npc::tickAnimationTags() {
+  // only own pose is touched here; the rest goes through NpcCommands, when ticked in parallel
   Animation::EvCount ev;
   const bool hasEvents = visual.processEvents(owner,lastEventTime,ev);
   visual.processLayers(owner);
-  visual.setNpcEffect(owner,*this,hnpc->effect,hnpc->flags);
+  NpcCommands::exec([this](){
+    visual.setNpcEffect(owner,*this,hnpc->effect,hnpc->flags);
+    });
   if(!hasEvents)
     return;
 
-  for(auto& i:ev.morph)
-    visual.startMMAnim(*this,i.anim,i.node);
+  if(!ev.morph.empty()) {
+    NpcCommands::exec([this,morph=ev.morph](){
+      for(auto& i:morph)
+        visual.startMMAnim(*this,i.anim,i.node);
+      });
+    }
   if(ev.groundSounds>0 && isPlayer() && (bodyStateMasked()!=BodyState::BS_SNEAK))
     world().sendImmediatePerc(*this,*this,*this,PERC_ASSESSQUIETSOUND);
   if(ev.def_opt_frame>0)
-    commitDamage();
-  implSetFightMode(ev);
-  tickTimedEvt(ev);
+    NpcCommands::exec([this](){ commitDamage(); });
+  NpcCommands::exec([this,ev=std::move(ev)]() mutable {
+    implSetFightMode(ev);
+    tickTimedEvt(ev);
+    });
+  }
+
+void Npc::tickPrepare(uint64_t dt) {
+  // thread-safe part of tick, see WorldObjects::tickNpcParallel
+  Profiler::Zone zone("Npc::tickPrepare");
+  tickAnimationTags();
+  mvAlgo.prefetch(dt);
   }
 
 void Npc::tick(uint64_t dt) {
+  Profiler::Zone zone("Npc::tick");
   // if(!isPlayer() && hnpc->id!=323)
   //   return;
   static bool dbg = false;
@@ -2100,7 +2123,10 @@ void Npc::tick(uint64_t dt) {
     return;
 
   tickAnimationTags();
+  tickAi(dt);
+  }
 
+void Npc::tickAi(uint64_t dt) {
   if(!visual.pose().hasAnim())
     setAnim(AnimationSolver::Idle);
 
@@ -3836,6 +3862,41 @@ bool Npc::perceptionProcess(Npc &pl) {
   return ret;
   }
 
+void Npc::prefetchPerception(const Npc& oth, const Npc& pl) const {
+  // mirrors perceptionProcess(pl): canSenseNpc tests only mid-point of the target
+  if(isPlayer() || &oth==this || processPolicy()!=Npc::AiNormal)
+    return;
+  if((hnpc->senses & int32_t(SensesBit::SENSE_SEE))==0)
+    return;
+
+  const bool asPlayer = (&oth==&pl && hasPerc(PERC_ASSESSPLAYER));
+  const bool asEnemy  = (hasPerc(PERC_ASSESSENEMY) && !oth.isDown() && isEnemy(oth));
+  const bool asBody   = (hasPerc(PERC_ASSESSBODY)  && oth.isDead());
+  if(!asPlayer && !asEnemy && !asBody)
+    return;
+
+  // assess-player is limited to view cone, others are not
+  const bool freeLos = asEnemy || asBody;
+  const auto mid = oth.bounds().midTr;
+  if(isInLosRange(mid,freeLos,0.f))
+    owner.requestLos(*this,oth,LOS_Mid,visual.mapHeadBone(),mid);
+  }
+
+void Npc::prefetchSeeNpc(const Npc& oth) const {
+  // mirrors fallback of canSeeNpc, that scripts use from perception handlers, when mid-point is blocked
+  const auto from = visual.mapHeadBone();
+  if(oth.isDown()) {
+    const auto ppos = oth.physic.position();
+    if(isInLosRange(ppos,true,0.f))
+      owner.requestLos(*this,oth,LOS_Physic,from,ppos);
+    }
+  if(oth.visual.visualSkeleton()==nullptr || oth.visual.visualSkeleton()->BIP01_HEAD==size_t(-1))
+    return;
+  const auto head = oth.visual.mapHeadBone();
+  if(isInLosRange(head,true,0.f))
+    owner.requestLos(*this,oth,LOS_Head,from,head);
+  }
+
 bool Npc::perceptionProcess(Npc &pl, Npc* victum, float quadDist, PercType perc) {
   float r = float(world().script().percRanges().at(perc, hnpc->senses_range));
   r = r*r;
@@ -4164,10 +4225,10 @@ void Npc::stopWalking() {
 
 bool Npc::canSeeNpc(const Npc &oth, bool freeLos) const {
   const auto mid = oth.bounds().midTr;
-  if(canSeeNpc(mid,freeLos))
+  if(canRayHitNpc(oth,LOS_Mid,mid,freeLos))
     return true;
   const auto ppos = oth.physic.position();
-  if(oth.isDown() && canSeeNpc(ppos,freeLos)) {
+  if(oth.isDown() && canRayHitNpc(oth,LOS_Physic,ppos,freeLos)) {
     // mid of dead npc may endedup inside a wall; extra check for physical center
     return true;
     }
@@ -4176,7 +4237,7 @@ bool Npc::canSeeNpc(const Npc &oth, bool freeLos) const {
   if(oth.visual.visualSkeleton()->BIP01_HEAD==size_t(-1))
     return false;
   auto head = oth.visual.mapHeadBone();
-  if(canSeeNpc(head,freeLos))
+  if(canRayHitNpc(oth,LOS_Head,head,freeLos))
     return true;
   return false;
   }
@@ -4195,27 +4256,34 @@ bool Npc::canSeeNpc(const Vec3 pos, bool freeLos) const {
   return canRayHitPoint(pos, freeLos);
   }
 
-bool Npc::canRayHitPoint(const Tempest::Vec3 pos, bool freeLos, float extRange) const {
+bool Npc::isInLosRange(const Tempest::Vec3 pos, bool freeLos, float extRange) const {
   const float range = float(hnpc->senses_range) + extRange;
   if(qDistTo(pos)>range*range)
     return false;
+  if(freeLos)
+    return true;
 
   static const double ref = std::cos(100*M_PI/180.0); // spec requires +-100 view angle range
-  const DynamicWorld* w   = owner.physic();
-  // npc eyesight height
-  auto head = visual.mapHeadBone();
-  if(freeLos) {
-    return !w->ray(head, pos).hasCol;
-    }
-
   float dx  = x-pos.x, dz=z-pos.z;
   float dir = angleDir(dx,dz);
   float da  = float(M_PI)*(visual.viewDirection()-dir)/180.f;
-  if(double(std::cos(da))<=ref) {
-    if(!w->ray(head, pos).hasCol)
-      return true;
-    }
-  return false;
+  return double(std::cos(da))<=ref;
+  }
+
+bool Npc::canRayHitPoint(const Tempest::Vec3 pos, bool freeLos, float extRange) const {
+  if(!isInLosRange(pos,freeLos,extRange))
+    return false;
+  // npc eyesight height
+  auto head = visual.mapHeadBone();
+  return !owner.physic()->ray(head, pos).hasCol;
+  }
+
+bool Npc::canRayHitNpc(const Npc& oth, LosPoint pt, const Tempest::Vec3 pos, bool freeLos, float extRange) const {
+  if(!isInLosRange(pos,freeLos,extRange))
+    return false;
+  // same as canRayHitPoint, but result is shared for short time across perception ticks
+  auto head = visual.mapHeadBone();
+  return owner.testLos(*this,oth,pt,head,pos);
   }
 
 SensesBit Npc::canSenseNpc(const Npc &oth, bool freeLos, float extRange) const {
@@ -4223,10 +4291,14 @@ SensesBit Npc::canSenseNpc(const Npc &oth, bool freeLos, float extRange) const {
   const auto st      = oth.bodyStateMasked();
   // https://github.com/Try/OpenGothic/pull/589#issuecomment-2045897394
   const bool isNoisy = (st!=BodyState::BS_SNEAK && oth.isPlayer());
-  return canSenseNpc(mid,freeLos,isNoisy,extRange);
+  return implCanSense(&oth,mid,freeLos,isNoisy,extRange);
   }
 
 SensesBit Npc::canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange) const {
+  return implCanSense(nullptr,pos,freeLos,isNoisy,extRange);
+  }
+
+SensesBit Npc::implCanSense(const Npc* oth, const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange) const {
   const float range = float(hnpc->senses_range)+extRange;
   if(qDistTo(pos)>range*range)
     return SensesBit::SENSE_NONE;
@@ -4238,8 +4310,10 @@ SensesBit Npc::canSenseNpc(const Tempest::Vec3 pos, bool freeLos, bool isNoisy,
     ret = ret | SensesBit::SENSE_HEAR;
     }
 
-  if((hnpc->senses & int32_t(SensesBit::SENSE_SEE))!=0 && canRayHitPoint(pos, freeLos, extRange)) {
-    ret = ret | SensesBit::SENSE_SEE;
+  if((hnpc->senses & int32_t(SensesBit::SENSE_SEE))!=0) {
+    const bool see = (oth!=nullptr) ? canRayHitNpc(*oth,LOS_Mid,pos,freeLos,extRange) : canRayHitPoint(pos,freeLos,extRange);
+    if(see)
+      ret = ret | SensesBit::SENSE_SEE;
     }
 
   return ret & SensesBit(hnpc->senses);
@@ -4327,7 +4401,16 @@ void Npc::updateTransform() {
   updateAnimation(0);
   }
 
-void Npc::updateAnimation(uint64_t dt) {
+void Npc::snapshot(RenderSnapshot& dst) {
+  auto& pose = visual.pose();
+  dst.push(this,RenderSnapshot::T_Npc,visual.transform(),pose.transform(),pose.boneCount());
+  }
+
+void Npc::setRenderPose(const Tempest::Matrix4x4* tr, size_t count) {
+  visual.setRenderPose(tr,count);
+  }
+
+void Npc::updateAnimation(uint64_t dt, bool updatePose) {
   const auto camera = Gothic::inst().camera();
   if(isPlayer() && camera!=nullptr && camera->isFree())
     dt = 0;
@@ -4360,7 +4443,13 @@ void Npc::updateAnimation(uint64_t dt) {
     durtyTranform = 0;
     }
 
-  bool syncAtt = visual.updateAnimation(this,owner,dt);
+  // skeleton may be updated at reduced rate (animation lod): accumulate time of skipped frames
+  animLodDt += dt;
+  if(!updatePose)
+    return;
+
+  bool syncAtt = visual.updateAnimation(this,owner,animLodDt);
+  animLodDt = 0;
   if(syncAtt)
     visual.syncAttaches();
   }
@@ -21,6 +21,7 @@
 
 class Interactive;
 class WayPoint;
+class RenderSnapshot;
 
 class Npc final {
   public:
@@ -112,6 +113,8 @@ class Npc final {
     void       setWalkMode(WalkBit m);
     auto       walkMode() const { return wlkMode; }
     void       tick(uint64_t dt);
+    void       tickPrepare(uint64_t dt);
+    void       tickAi(uint64_t dt);
     void       tickAnimationTags();
     bool       startClimb(JumpStatus jump);
 
@@ -130,8 +133,10 @@ class Npc final {
     float      qDistTo(const Interactive& p) const;
     float      qDistTo(const Item& p) const;
 
-    void       updateAnimation(uint64_t dt);
+    void       updateAnimation(uint64_t dt, bool updatePose = true);
     void       updateTransform();
+    void       snapshot(RenderSnapshot& dst);
+    void       setRenderPose(const Tempest::Matrix4x4* tr, size_t count);
 
     std::string_view displayName() const;
     auto       displayPosition() const -> Tempest::Vec3;
@@ -287,6 +292,8 @@ class Npc final {
     void      setPerceptionDisable(PercType t);
 
     bool      perceptionProcess(Npc& pl);
+    void      prefetchPerception(const Npc& oth, const Npc& pl) const;
+    void      prefetchSeeNpc(const Npc& oth) const;
     bool      perceptionProcess(Npc& pl, Npc *victum, float quadDist, PercType perc);
     bool      hasPerc(PercType perc) const;
     uint64_t  percNextTime() const;
@@ -408,6 +415,12 @@ class Npc final {
     void      runEffect  (Effect&& e);
 
   private:
+    enum LosPoint : uint8_t {
+      LOS_Mid,
+      LOS_Physic,
+      LOS_Head,
+      };
+
     struct Routine final {
       gtime           start;
       gtime           end;
@@ -492,6 +505,9 @@ class Npc final {
     void      commitDamage();
     Npc*      updateNearestEnemy();
     Npc*      updateNearestBody();
+    bool      isInLosRange(const Tempest::Vec3 pos, bool freeLos, float extRange) const;
+    bool      canRayHitNpc(const Npc& oth, LosPoint pt, const Tempest::Vec3 pos, bool freeLos, float extRange=0.f) const;
+    auto      implCanSense(const Npc* oth, const Tempest::Vec3 pos, bool freeLos, bool isNoisy, float extRange) const -> SensesBit;
     bool      checkHealth(bool onChange, bool forceKill);
     void      onNoHealth(bool death, HitSound sndMask);
     bool      hasAutoroll() const;
@@ -534,6 +550,7 @@ class Npc final {
     // visual props (cache)
     uint8_t                        durtyTranform=0;
     Tempest::Vec3                  lastGroundNormal;
+    uint64_t                       animLodDt=0;
 
     DynamicWorld::NpcItem          physic;
 
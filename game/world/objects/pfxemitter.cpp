@@ -43,6 +43,7 @@ PfxEmitter::PfxEmitter(World& world, const zenkit::VirtualObject& vob) {
     std::lock_guard<std::recursive_mutex> guard(owner.sync);
     bucket = &owner.getBucket(*decl);
     id     = bucket->allocEmitter();
+    bucket->get(id).ambient = true;
     }
   else if(auto decal = dynamic_cast<const zenkit::VisualDecal*>(vob.visual.get())) {
     Material mat(*decal);
@@ -114,7 +114,7 @@ void Vob::recalculateTransform() {
       case zenkit::VirtualObjectType::oCMobSwitch:
       case zenkit::VirtualObjectType::oCMobLadder:
       case zenkit::VirtualObjectType::oCMobWheel:
-        world.invalidateVobIndex();
+        world.updateVobIndex(*this);
         break;
       default:
         break;
@@ -236,13 +236,27 @@ std::unique_ptr<Vob> Vob::load(Vob* parent, World& world, const zenkit::VirtualO
   return std::unique_ptr<Vob>(new Vob(parent,world,vob,flags));
   }
 
+static Serialize::Snapshot saveState(const Vob& vob, World& world) {
+  Serialize::Snapshot snap;
+  {
+  Serialize s(snap);
+  s.setContext(&world);
+  vob.save(s);
+  }
+  return snap;
+  }
+
 void Vob::saveVobTree(Serialize& fin) const {
   for(auto& i:child)
     i->saveVobTree(fin);
   if(vobType==zenkit::VirtualObjectType::zCVob)
     return;
-  if(vobObjectID!=uint32_t(-1))
-    save(fin);
+  if(vobObjectID==uint32_t(-1))
+    return;
+  // vobs, that are unchanged since construction from *.zen, are not stored
+  auto snap = saveState(*this,world);
+  if(snap.bytes()!=baseline)
+    fin.appendSnapshot(snap);
   }
 
 void Vob::loadVobTree(Serialize& fin) {
@@ -254,10 +268,20 @@ void Vob::loadVobTree(Serialize& fin) {
 
   for(auto& i:child)
     i->loadVobTree(fin);
-  if(vobObjectID!=uint32_t(-1) && vobType!=zenkit::VirtualObjectType::zCVob)
+  if(vobObjectID==uint32_t(-1) || vobType==zenkit::VirtualObjectType::zCVob)
+    return;
+  if(fin.hasEntry("worlds/",fin.worldName(),"/mobsi/",vobObjectID,"/data"))
     load(fin);
   }
 
+void Vob::captureBaseline() {
+  for(auto& i:child)
+    i->captureBaseline();
+  if(vobObjectID==uint32_t(-1) || vobType==zenkit::VirtualObjectType::zCVob)
+    return;
+  baseline = saveState(*this,world).bytes();
+  }
+
 void Vob::save(Serialize& fout) const {
   fout.setEntry("worlds/",fout.worldName(),"/mobsi/",vobObjectID,"/data");
   fout.write(uint8_t(vobType),pos,local);
@@ -30,6 +30,8 @@ class Vob {
     void          loadVobTree(Serialize& fin);
     virtual void  load(Serialize& fin);
 
+    void          captureBaseline();
+
     Tempest::Vec3 position() const;
     auto          transform() const -> const Tempest::Matrix4x4& { return pos; }
     void          setGlobalTransform(const Tempest::Matrix4x4& p);
@@ -53,6 +55,7 @@ class Vob {
 
     Tempest::Matrix4x4                pos, local;
     Vob*                              parent = nullptr;
+    std::vector<uint8_t>              baseline;
 
     void          recalculateTransform();
   };
@@ -1,132 +1,173 @@
 #include "spaceindex.h"
 
+#include <cmath>
+
 #include "world/objects/vob.h"
 
+SpatialHash::SpatialHash(float cellSize)
+  :cellSize(cellSize), cellSizeInv(1.f/cellSize) {
+  }
+
+void SpatialHash::clear() {
+  cells.clear();
+  slots.clear();
+  }
+
+int32_t SpatialHash::cellOf(float v) const {
+  return int32_t(std::floor(v*cellSizeInv));
+  }
+
+uint64_t SpatialHash::key(int32_t x, int32_t z) {
+  return (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
+  }
+
+uint64_t SpatialHash::keyOf(const Tempest::Vec3& pos) const {
+  return key(cellOf(pos.x),cellOf(pos.z));
+  }
+
+void SpatialHash::insert(const void* obj, const Tempest::Vec3& pos) {
+  if(move(obj,pos))
+    return;
+  const uint64_t k    = keyOf(pos);
+  auto&          cell = cells[k];
+  slots[obj] = Slot{k,uint32_t(cell.size())};
+  cell.push_back(Entry{obj,pos});
+  }
+
+bool SpatialHash::erase(const void* obj) {
+  auto it = slots.find(obj);
+  if(it==slots.end())
+    return false;
+  implErase(it->second);
+  slots.erase(it);
+  return true;
+  }
+
+bool SpatialHash::move(const void* obj, const Tempest::Vec3& pos) {
+  auto it = slots.find(obj);
+  if(it==slots.end())
+    return false;
+
+  auto&          s = it->second;
+  const uint64_t k = keyOf(pos);
+  if(s.cell==k) {
+    cells[k][s.id].pos = pos;
+    return true;
+    }
+
+  implErase(s);
+  auto& cell = cells[k];
+  s.cell = k;
+  s.id   = uint32_t(cell.size());
+  cell.push_back(Entry{obj,pos});
+  return true;
+  }
+
+bool SpatialHash::contains(const void* obj) const {
+  return slots.find(obj)!=slots.end();
+  }
+
+void SpatialHash::implErase(const Slot& s) {
+  auto it = cells.find(s.cell);
+  if(it==cells.end())
+    return;
+  auto& cell = it->second;
+  if(s.id+1u!=cell.size()) {
+    cell[s.id] = cell.back();
+    slots[cell[s.id].obj].id = s.id;
+    }
+  cell.pop_back();
+  // moving objects would leave a trail of empty cells otherwise
+  if(cell.empty())
+    cells.erase(it);
+  }
+
+
 void BaseSpaceIndex::clear() {
   arr.clear();
-  index.clear();
+  arrId.clear();
   dynamic.clear();
+  grid.clear();
+  durty = false;
   }
 
 void BaseSpaceIndex::invalidate() {
-  index.clear();
-  dynamic.clear();
+  durty = true;
+  }
+
+void BaseSpaceIndex::update(const Vob* v) {
+  if(durty)
+    return;
+  if(v->isDynamic()) {
+    // dynamic objects are always reported by find, no need to track position
+    if(grid.contains(v))
+      durty = true;
+    return;
+    }
+  if(!grid.move(v,v->position()) && arrId.find(v)!=arrId.end())
+    durty = true;
   }
 
 void BaseSpaceIndex::add(Vob* v) {
+  arrId[v] = arr.size();
   arr.push_back(v);
-  index.reserve(arr.size());
-  index.clear();
-  dynamic.clear();
+  if(durty)
+    return;
+  if(v->isDynamic())
+    dynamic.push_back(v); else
+    grid.insert(v,v->position());
   }
 
 void BaseSpaceIndex::del(Vob* v) {
-  for(size_t i=0;i<arr.size();++i) {
-    if(arr[i]==v) {
-      arr[i] = arr.back();
-      arr.pop_back();
-      index.clear();
-      dynamic.clear();
-      return;
-      }
+  auto it = arrId.find(v);
+  if(it==arrId.end())
+    return;
+
+  const size_t id = it->second;
+  arrId.erase(it);
+  if(id+1!=arr.size()) {
+    arr[id] = arr.back();
+    arrId[arr[id]] = id;
+    }
+  arr.pop_back();
+
+  if(!grid.erase(v)) {
+    for(size_t i=0; i<dynamic.size(); ++i)
+      if(dynamic[i]==v) {
+        dynamic[i] = dynamic.back();
+        dynamic.pop_back();
+        break;
+        }
     }
   }
 
 bool BaseSpaceIndex::hasObject(const Vob* v) const {
   if(v==nullptr)
     return false;
-  for(size_t i=0;i<arr.size();++i)
-    if(arr[i]==v)
-      return true;
-  return false;
+  return arrId.find(v)!=arrId.end();
   }
 
 void BaseSpaceIndex::find(const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(index.size()==0)
-    buildIndex();
+  if(durty)
+    resync();
   for(auto& i:dynamic)
     (*func)(ctx,i);
-  implFind(index.data(),index.size(),0,p,R,ctx,func);
+  const float qR = (R+675.f);//v->extendedSearchRadius());
+  grid.find(p,qR,[ctx,func](void* v) {
+    (*func)(ctx,reinterpret_cast<Vob*>(v));
+    });
   }
 
-void BaseSpaceIndex::buildIndex() {
-  size_t cnt = 0;
-  index.resize(arr.size());
+void BaseSpaceIndex::resync() {
+  // objects can be moved, or change dynamic state - update only what is needed; no rebuild
   dynamic.clear();
-  for(size_t i=0; i<arr.size(); ++i) {
-    if(arr[i]->isDynamic()) {
-      dynamic.push_back(arr[i]);
+  for(auto v:arr) {
+    if(v->isDynamic()) {
+      grid.erase(v);
+      dynamic.push_back(v);
       } else {
-      index[cnt] = arr[i];
-      ++cnt;
+      grid.insert(v,v->position());
       }
     }
-  index.resize(cnt);
-  buildIndex(index.data(),index.size(),0);
-  }
-
-void BaseSpaceIndex::buildIndex(Vob** v, size_t cnt, uint8_t depth) {
-  depth%=3;
-  sort(v,cnt,depth);
-  size_t mid = cnt/2;
-  if(mid>0) {
-    // [0..mid)
-    buildIndex(v,mid,uint8_t(depth+1u));
-    }
-  if(mid+1<cnt) {
-    // (mid..cnt)
-    buildIndex(v+mid+1,cnt-mid-1,uint8_t(depth+1u));
-    }
-  }
-
-void BaseSpaceIndex::sort(Vob** v, size_t cnt, uint8_t component) {
-  bool (*predicate)(const Vob* a, const Vob* b) = nullptr;
-  switch(component) {
-    case 0:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().x < b->position().x; };
-      break;
-    case 1:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().y < b->position().y; };
-      break;
-    case 2:
-      predicate = [](const Vob* a, const Vob* b){ return a->position().z < b->position().z; };
-      break;
-    }
-  std::sort(v,v+cnt,predicate);
-  }
-
-void BaseSpaceIndex::implFind(Vob** v, size_t cnt, uint8_t depth,
-                              const Tempest::Vec3& p, float R, const void* ctx, void (*func)(const void*, Vob*)) {
-  if(cnt==0)
-    return;
-
-  auto mid = cnt/2;
-  auto pos = v[mid]->position();
-  auto qR  = (R+675.0);//v[mid]->extendedSearchRadius());
-
-  if((pos-p).quadLength()<=qR*qR) {
-    func(ctx,v[mid]);
-    }
-
-  depth%=3;
-  switch(depth) {
-    case 0:
-      if(p.x-qR<=pos.x)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.x+qR>=pos.x)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 1:
-      if(p.y-qR<=pos.y)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.y+qR>=pos.y)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    case 2:
-      if(p.z-qR<=pos.z)
-        implFind(v,mid,uint8_t(depth+1u),p,R, ctx,func);
-      if(p.z+qR>=pos.z)
-        implFind(v+mid+1,cnt-mid-1,uint8_t(depth+1u),p,R, ctx,func);
-      break;
-    }
+  durty = false;
   }
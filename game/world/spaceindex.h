@@ -5,17 +5,83 @@
 #include <algorithm>
 #include <array>
 #include <memory>
+#include <unordered_map>
 #include <Tempest/Point>
 
 #include "utils/workers.h"
 
 class Vob;
 
+// uniform grid over XZ-plane, with O(1) insert/erase/move
+class SpatialHash final {
+  public:
+    explicit SpatialHash(float cellSize = 2000.f);
+
+    void   clear();
+    size_t size() const { return slots.size(); }
+
+    void   insert  (const void* obj, const Tempest::Vec3& pos);
+    bool   erase   (const void* obj);
+    bool   move    (const void* obj, const Tempest::Vec3& pos);
+    bool   contains(const void* obj) const;
+
+    // note: func must not modify this index
+    template<class Func>
+    void   find(const Tempest::Vec3& p, float R, const Func& func) const;
+
+  private:
+    struct Entry {
+      const void*   obj = nullptr;
+      Tempest::Vec3 pos;
+      };
+    struct Slot {
+      uint64_t cell = 0;
+      uint32_t id   = 0;
+      };
+
+    int32_t   cellOf(float v) const;
+    uint64_t  keyOf(const Tempest::Vec3& pos) const;
+    static uint64_t key(int32_t x, int32_t z);
+    void      implErase(const Slot& s);
+
+    float                                       cellSize    = 0;
+    float                                       cellSizeInv = 0;
+    std::unordered_map<uint64_t,std::vector<Entry>> cells;
+    std::unordered_map<const void*,Slot>        slots;
+  };
+
+template<class Func>
+void SpatialHash::find(const Tempest::Vec3& p, float R, const Func& func) const {
+  const float qR = R*R;
+  auto test = [&](const std::vector<Entry>& cell) {
+    for(auto& e:cell)
+      if((e.pos-p).quadLength()<=qR)
+        func(const_cast<void*>(e.obj));
+    };
+
+  const int32_t x0 = cellOf(p.x-R), x1 = cellOf(p.x+R);
+  const int32_t z0 = cellOf(p.z-R), z1 = cellOf(p.z+R);
+  const uint64_t area = uint64_t(x1-x0+1)*uint64_t(z1-z0+1);
+  if(area>=cells.size()) {
+    for(auto& i:cells)
+      test(i.second);
+    return;
+    }
+
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t z=z0; z<=z1; ++z) {
+      auto it = cells.find(key(x,z));
+      if(it!=cells.end())
+        test(it->second);
+      }
+  }
+
 class BaseSpaceIndex {
   public:
     void   clear();
     size_t size() const { return arr.size(); }
     void   invalidate();
+    void   update(const Vob* v);
 
   protected:
     BaseSpaceIndex() = default;
@@ -30,14 +96,13 @@ class BaseSpaceIndex {
     Vob*const*         data() const { return arr.data(); }
 
   private:
-    std::vector<Vob*>  arr;
-    std::vector<Vob*>  index;
-    std::vector<Vob*>  dynamic;
-
-    void               buildIndex();
-    void               buildIndex(Vob** v, size_t cnt, uint8_t depth);
-    void               sort(Vob** v, size_t cnt, uint8_t component);
-    void               implFind(Vob** v, size_t cnt, uint8_t depth, const Tempest::Vec3& p, float R, const void* ctx, void(*func)(const void*, Vob*));
+    std::vector<Vob*>                      arr;
+    std::unordered_map<const Vob*,size_t>  arrId;
+    std::vector<Vob*>                      dynamic;
+    SpatialHash                            grid;
+    bool                                   durty = false;
+
+    void               resync();
   };
 
 template<class Func>
@@ -82,4 +147,3 @@ class SpaceIndex final : public BaseSpaceIndex {
       BaseSpaceIndex::parallelFor([&func](Vob* v){ func(*reinterpret_cast<T*>(v)); });
       }
   };
-
@@ -0,0 +1,428 @@
+#include "wayhierarchy.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+
+#include "utils/assetcache.h"
+#include "utils/fnv.h"
+#include "utils/workers.h"
+#include "resources.h"
+#include "waypoint.h"
+
+using namespace Tempest;
+
+void WayHierarchy::clear() {
+  adjOffset.clear();
+  adjTo.clear();
+  adjLen.clear();
+  pos.clear();
+  pointCluster.clear();
+  pointLocal.clear();
+  clusters.clear();
+  portals.clear();
+  linkOffset.clear();
+  linkTo.clear();
+  linkLen.clear();
+  }
+
+void WayHierarchy::build(const std::vector<WayPoint>& wp) {
+  buildGraph(wp);
+  Workers::parallelFor(clusters,[this](Cluster& c){
+    buildCluster(c);
+    });
+  buildLinks();
+  }
+
+bool WayHierarchy::load(std::string_view world, uint64_t hash, const std::vector<WayPoint>& wp) {
+  clear();
+
+  AssetCache::Reader rd;
+  if(!Resources::assetCache().load(AssetCache::K_Waynet,world,rd))
+    return false;
+
+  uint32_t version = 0, count = 0;
+  uint64_t h       = 0;
+  rd.read(version);
+  rd.read(h);
+  rd.read(count);
+  if(!rd.isOk() || version!=FileVersion || h!=hash || count!=wp.size())
+    return false;
+
+  buildGraph(wp);
+  bool valid = true;
+  for(auto& c:clusters) {
+    rd.read(c.dist);
+    rd.read(c.parent);
+    const size_t p = c.portals.size();
+    const size_t m = c.members.size();
+    if(!rd.isOk() || c.dist.size()!=p*p || c.parent.size()!=p*m) {
+      valid = false;
+      break;
+      }
+    for(auto i:c.parent)
+      if(i!=NoId && i>=m)
+        valid = false;
+    }
+
+  if(!valid || rd.remain()!=0) {
+    clear();
+    return false;
+    }
+  buildLinks();
+  return true;
+  }
+
+void WayHierarchy::save(std::string_view world, uint64_t hash) const {
+  if(!Resources::assetCache().isEnabled())
+    return;
+
+  AssetCache::Writer wr;
+  wr.write(uint32_t(FileVersion));
+  wr.write(hash);
+  wr.write(uint32_t(pointCluster.size()));
+  for(auto& c:clusters) {
+    wr.write(c.dist);
+    wr.write(c.parent);
+    }
+  Resources::assetCache().save(AssetCache::K_Waynet,world,wr);
+  }
+
+uint64_t WayHierarchy::hashOf(const std::vector<WayPoint>& wp) {
+  // FNV-1a over everything hierarchy depends on: positions(adjusted to ground) and connections
+  uint64_t h = Fnv::Basis;
+  auto mix = [&h](const void* data, size_t sz) {
+    h = Fnv::hash(data,sz,h);
+    };
+  const uint32_t cs = ClusterSize;
+  mix(&cs,sizeof(cs));
+  for(auto& w:wp) {
+    mix(&w.x,sizeof(w.x));
+    mix(&w.y,sizeof(w.y));
+    mix(&w.z,sizeof(w.z));
+    for(auto& c:w.connections()) {
+      const uint32_t id = uint32_t(std::distance<const WayPoint*>(wp.data(),c.point));
+      mix(&id,   sizeof(id));
+      mix(&c.len,sizeof(c.len));
+      }
+    }
+  return h;
+  }
+
+void WayHierarchy::buildGraph(const std::vector<WayPoint>& wp) {
+  clear();
+  const size_t n = wp.size();
+
+  pos.resize(n*3);
+  adjOffset.resize(n+1);
+  for(size_t i=0; i<n; ++i) {
+    pos[i*3+0] = wp[i].x;
+    pos[i*3+1] = wp[i].y;
+    pos[i*3+2] = wp[i].z;
+    adjOffset[i] = uint32_t(adjTo.size());
+    for(auto& c:wp[i].connections()) {
+      auto id = std::distance<const WayPoint*>(wp.data(),c.point);
+      if(id<0 || size_t(id)>=n)
+        continue;
+      adjTo .push_back(uint32_t(id));
+      adjLen.push_back(c.len);
+      }
+    }
+  adjOffset[n] = uint32_t(adjTo.size());
+
+  std::unordered_map<uint64_t,uint32_t> cells;
+  pointCluster.resize(n);
+  pointLocal  .resize(n);
+  for(size_t i=0; i<n; ++i) {
+    const int32_t  x   = int32_t(std::floor(wp[i].x/float(ClusterSize)));
+    const int32_t  z   = int32_t(std::floor(wp[i].z/float(ClusterSize)));
+    const uint64_t key = (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
+    auto it = cells.find(key);
+    if(it==cells.end()) {
+      it = cells.emplace(key,uint32_t(clusters.size())).first;
+      clusters.emplace_back();
+      }
+    auto& c = clusters[it->second];
+    pointCluster[i] = it->second;
+    pointLocal  [i] = uint32_t(c.members.size());
+    c.members.push_back(uint32_t(i));
+    }
+
+  for(auto& c:clusters) {
+    for(auto i:c.members) {
+      for(uint32_t r=adjOffset[i]; r<adjOffset[i+1]; ++r)
+        if(pointCluster[adjTo[r]]!=pointCluster[i]) {
+          c.portals.push_back(i);
+          break;
+          }
+      }
+    }
+  }
+
+void WayHierarchy::buildCluster(Cluster& c) {
+  const size_t p = c.portals.size();
+  const size_t m = c.members.size();
+  c.dist  .resize(p*p);
+  c.parent.resize(p*m);
+
+  Search        s;
+  const int32_t zero = 0;
+  for(size_t i=0; i<p; ++i) {
+    search(c,&pointLocal[c.portals[i]],&zero,1,s);
+    for(size_t r=0; r<p; ++r)
+      c.dist[i*p+r] = s.dist[pointLocal[c.portals[r]]];
+    std::copy(s.parent.begin(),s.parent.end(),c.parent.begin()+ptrdiff_t(i*m));
+    }
+  }
+
+void WayHierarchy::buildLinks() {
+  std::vector<uint32_t> portalOf(pointCluster.size(),NoId);
+  for(auto& c:clusters) {
+    c.portalBase = uint32_t(portals.size());
+    for(auto i:c.portals) {
+      portalOf[i] = uint32_t(portals.size());
+      portals.push_back(i);
+      }
+    }
+
+  linkOffset.resize(portals.size()+1);
+  for(size_t g=0; g<portals.size(); ++g) {
+    const uint32_t id = portals[g];
+    const auto&    c  = clusters[pointCluster[id]];
+    const size_t   p  = c.portals.size();
+    const size_t   k  = g-c.portalBase;
+    linkOffset[g] = uint32_t(linkTo.size());
+    for(size_t r=0; r<p; ++r) {
+      const int32_t d = c.dist[k*p+r];
+      if(r==k || d<0)
+        continue;
+      linkTo .push_back(c.portalBase+uint32_t(r));
+      linkLen.push_back(d);
+      }
+    for(uint32_t r=adjOffset[id]; r<adjOffset[id+1]; ++r) {
+      const uint32_t to = adjTo[r];
+      if(pointCluster[to]==pointCluster[id])
+        continue;
+      linkTo .push_back(portalOf[to]);
+      linkLen.push_back(adjLen[r]);
+      }
+    }
+  linkOffset[portals.size()] = uint32_t(linkTo.size());
+  }
+
+void WayHierarchy::search(const Cluster& c, const uint32_t* seed, const int32_t* seedCost, size_t seedSz, Search& out) const {
+  // dijkstra, restricted to single cluster
+  const uint32_t cId = pointCluster[c.members[0]];
+  out.dist  .assign(c.members.size(),-1);
+  out.parent.assign(c.members.size(),NoId);
+
+  std::vector<std::pair<int32_t,uint32_t>> heap;
+  auto cmp = [](const std::pair<int32_t,uint32_t>& a, const std::pair<int32_t,uint32_t>& b) {
+    return a.first>b.first;
+    };
+  auto push = [&](uint32_t id, int32_t d, uint32_t parent) {
+    out.dist  [id] = d;
+    out.parent[id] = parent;
+    heap.emplace_back(d,id);
+    std::push_heap(heap.begin(),heap.end(),cmp);
+    };
+
+  for(size_t i=0; i<seedSz; ++i)
+    if(out.dist[seed[i]]<0 || seedCost[i]<out.dist[seed[i]])
+      push(seed[i],seedCost[i],NoId);
+
+  while(!heap.empty()) {
+    std::pop_heap(heap.begin(),heap.end(),cmp);
+    const auto [d,id] = heap.back();
+    heap.pop_back();
+    if(d!=out.dist[id])
+      continue;
+    const uint32_t pt = c.members[id];
+    for(uint32_t r=adjOffset[pt]; r<adjOffset[pt+1]; ++r) {
+      const uint32_t to = adjTo[r];
+      if(pointCluster[to]!=cId)
+        continue;
+      const uint32_t l  = pointLocal[to];
+      const int32_t  d1 = d+adjLen[r];
+      if(out.dist[l]<0 || d1<out.dist[l])
+        push(l,d1,id);
+      }
+    }
+  }
+
+int32_t WayHierarchy::distance(uint32_t a, uint32_t b) const {
+  const float dx = pos[a*3+0]-pos[b*3+0];
+  const float dy = pos[a*3+1]-pos[b*3+1];
+  const float dz = pos[a*3+2]-pos[b*3+2];
+  return int32_t(std::sqrt(dx*dx+dy*dy+dz*dz));
+  }
+
+bool WayHierarchy::findPath(const uint32_t* begin, const int32_t* beginCost, size_t beginSz, uint32_t end,
+                            std::vector<uint32_t>& path, uint32_t& first, int32_t& cost) const {
+  if(clusters.empty() || end>=pointCluster.size() || beginSz==0)
+    return false;
+  const uint32_t ce = pointCluster[end];
+  for(size_t i=0; i<beginSz; ++i)
+    if(begin[i]>=pointCluster.size() || pointCluster[begin[i]]==ce)
+      return false;
+
+  struct Context {
+    Search                endS;
+    std::vector<Search>   startS;
+    std::vector<uint32_t> startCluster;
+    std::vector<uint32_t> seed;
+    std::vector<int32_t>  seedCost;
+
+    std::vector<int32_t>  g;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> visit, closed;
+    uint32_t              gen = 0;
+    std::vector<std::pair<int32_t,uint32_t>> heap;
+    std::vector<uint32_t> chain, tmp;
+    };
+  static thread_local Context ctx;
+
+  const int32_t zero = 0;
+  search(clusters[ce],&pointLocal[end],&zero,1,ctx.endS);
+
+  ctx.startCluster.clear();
+  for(size_t i=0; i<beginSz; ++i) {
+    const uint32_t cs = pointCluster[begin[i]];
+    if(std::find(ctx.startCluster.begin(),ctx.startCluster.end(),cs)!=ctx.startCluster.end())
+      continue;
+    ctx.seed.clear();
+    ctx.seedCost.clear();
+    for(size_t r=i; r<beginSz; ++r)
+      if(pointCluster[begin[r]]==cs) {
+        ctx.seed    .push_back(pointLocal[begin[r]]);
+        ctx.seedCost.push_back(beginCost[r]);
+        }
+    if(ctx.startS.size()<=ctx.startCluster.size())
+      ctx.startS.resize(ctx.startCluster.size()+1);
+    search(clusters[cs],ctx.seed.data(),ctx.seedCost.data(),ctx.seed.size(),ctx.startS[ctx.startCluster.size()]);
+    ctx.startCluster.push_back(cs);
+    }
+
+  // A* over portals; last node is the end point
+  const uint32_t endNode  = uint32_t(portals.size());
+  const uint32_t NoParent = NoId;
+  if(ctx.visit.size()<portals.size()+1) {
+    ctx.g     .resize(portals.size()+1);
+    ctx.parent.resize(portals.size()+1);
+    ctx.visit .resize(portals.size()+1,0);
+    ctx.closed.resize(portals.size()+1,0);
+    }
+  ctx.gen++;
+  if(ctx.gen==0) {
+    std::fill(ctx.visit .begin(),ctx.visit .end(),0);
+    std::fill(ctx.closed.begin(),ctx.closed.end(),0);
+    ctx.gen = 1;
+    }
+  ctx.heap.clear();
+
+  const uint32_t gen = ctx.gen;
+  auto cmp = [](const std::pair<int32_t,uint32_t>& a, const std::pair<int32_t,uint32_t>& b) {
+    return a.first>b.first;
+    };
+  auto push = [&](uint32_t id, int32_t g, uint32_t parent) {
+    if(ctx.visit[id]==gen && ctx.g[id]<=g)
+      return;
+    ctx.g     [id] = g;
+    ctx.parent[id] = parent;
+    ctx.visit [id] = gen;
+    const int32_t h = (id==endNode ? 0 : distance(portals[id],end));
+    ctx.heap.emplace_back(g+h,id);
+    std::push_heap(ctx.heap.begin(),ctx.heap.end(),cmp);
+    };
+
+  for(size_t i=0; i<ctx.startCluster.size(); ++i) {
+    auto& c = clusters[ctx.startCluster[i]];
+    auto& s = ctx.startS[i];
+    for(size_t r=0; r<c.portals.size(); ++r) {
+      const int32_t d = s.dist[pointLocal[c.portals[r]]];
+      if(d>=0)
+        push(c.portalBase+uint32_t(r),d,NoParent);
+      }
+    }
+
+  bool found = false;
+  while(!ctx.heap.empty()) {
+    std::pop_heap(ctx.heap.begin(),ctx.heap.end(),cmp);
+    const uint32_t id = ctx.heap.back().second;
+    ctx.heap.pop_back();
+    if(ctx.closed[id]==gen)
+      continue;
+    ctx.closed[id] = gen;
+    if(id==endNode) {
+      found = true;
+      break;
+      }
+
+    const int32_t g0 = ctx.g[id];
+    for(uint32_t r=linkOffset[id]; r<linkOffset[id+1]; ++r) {
+      const uint32_t next = linkTo[r];
+      if(ctx.closed[next]!=gen)
+        push(next,g0+linkLen[r],id);
+      }
+    if(pointCluster[portals[id]]==ce) {
+      const int32_t d = ctx.endS.dist[pointLocal[portals[id]]];
+      if(d>=0)
+        push(endNode,g0+d,id);
+      }
+    }
+
+  path.clear();
+  if(!found) {
+    first = NoId;
+    cost  = -1;
+    return true;
+    }
+
+  ctx.chain.clear();
+  for(uint32_t at=ctx.parent[endNode]; at!=NoParent; at=ctx.parent[at])
+    ctx.chain.push_back(at);
+  std::reverse(ctx.chain.begin(),ctx.chain.end());
+
+  // refine abstract path; assemble it from begin to end first
+  {
+    const uint32_t p0 = portals[ctx.chain[0]];
+    const uint32_t cs = pointCluster[p0];
+    auto&          c  = clusters[cs];
+    auto&          s  = ctx.startS[size_t(std::distance(ctx.startCluster.begin(),std::find(ctx.startCluster.begin(),ctx.startCluster.end(),cs)))];
+    uint32_t       at = pointLocal[p0];
+    while(true) {
+      path.push_back(c.members[at]);
+      if(s.parent[at]==NoId)
+        break;
+      at = s.parent[at];
+      }
+    first = c.members[at];
+    cost  = ctx.g[endNode] - s.dist[at];
+    std::reverse(path.begin(),path.end());
+  }
+
+  for(size_t i=1; i<ctx.chain.size(); ++i) {
+    const uint32_t a = portals[ctx.chain[i-1]];
+    const uint32_t b = portals[ctx.chain[i]];
+    if(pointCluster[a]!=pointCluster[b]) {
+      path.push_back(b);
+      continue;
+      }
+    auto&    c   = clusters[pointCluster[a]];
+    auto     row = c.parent.begin()+ptrdiff_t(size_t(ctx.chain[i-1]-c.portalBase)*c.members.size());
+    ctx.tmp.clear();
+    for(uint32_t at=pointLocal[b]; at!=pointLocal[a]; at=row[at])
+      ctx.tmp.push_back(c.members[at]);
+    path.insert(path.end(),ctx.tmp.rbegin(),ctx.tmp.rend());
+    }
+
+  {
+    auto&    c  = clusters[ce];
+    uint32_t at = ctx.endS.parent[pointLocal[portals[ctx.chain.back()]]];
+    for(; at!=NoId; at=ctx.endS.parent[at])
+      path.push_back(c.members[at]);
+  }
+
+  std::reverse(path.begin(),path.end());
+  return true;
+  }
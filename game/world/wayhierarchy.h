@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+class WayPoint;
+
+// two-level waynet: waypoints are grouped into XZ-clusters; abstract graph consists of
+// cluster entrances(portals) with precomputed intra-cluster distance tables
+class WayHierarchy final {
+  public:
+    WayHierarchy() = default;
+
+    void            clear();
+    bool            isEmpty() const { return clusters.empty(); }
+
+    void            build(const std::vector<WayPoint>& wp);
+    // cached in asset cache per world; hash covers waypoints, archive fingerprint covers the rest
+    bool            load (std::string_view world, uint64_t hash, const std::vector<WayPoint>& wp);
+    void            save (std::string_view world, uint64_t hash) const;
+
+    static uint64_t hashOf(const std::vector<WayPoint>& wp);
+
+    // returns false, if query is local to the end cluster - use flat search instead
+    // path is stored from end to begin
+    bool            findPath(const uint32_t* begin, const int32_t* beginCost, size_t beginSz, uint32_t end,
+                             std::vector<uint32_t>& path, uint32_t& first, int32_t& cost) const;
+
+  private:
+    enum : uint32_t {
+      NoId        = uint32_t(-1),
+      ClusterSize = 4000,
+      FileVersion = 2,
+      };
+
+    struct Cluster {
+      std::vector<uint32_t> members;
+      std::vector<uint32_t> portals;
+      std::vector<int32_t>  dist;   // portals x portals
+      std::vector<uint32_t> parent; // portals x members, local id of previous point on the way to portal
+      uint32_t              portalBase = 0;
+      };
+
+    struct Search {
+      std::vector<int32_t>  dist;
+      std::vector<uint32_t> parent;
+      };
+
+    void            buildGraph(const std::vector<WayPoint>& wp);
+    void            buildLinks();
+    void            buildCluster(Cluster& c);
+    void            search(const Cluster& c, const uint32_t* seed, const int32_t* seedCost, size_t seedSz, Search& out) const;
+    int32_t         distance(uint32_t a, uint32_t b) const;
+
+    // concrete graph
+    std::vector<uint32_t> adjOffset;
+    std::vector<uint32_t> adjTo;
+    std::vector<int32_t>  adjLen;
+    std::vector<float>    pos;
+
+    std::vector<uint32_t> pointCluster, pointLocal;
+    std::vector<Cluster>  clusters;
+
+    // abstract graph over portals
+    std::vector<uint32_t> portals;
+    std::vector<uint32_t> linkOffset;
+    std::vector<uint32_t> linkTo;
+    std::vector<int32_t>  linkLen;
+  };
@@ -3,8 +3,10 @@
 #include <Tempest/Log>
 #include <algorithm>
 #include <limits>
+#include <cmath>
 
 #include "utils/dbgpainter.h"
+#include "utils/fnv.h"
 #include "utils/versioninfo.h"
 #include "world/objects/interactive.h"
 #include "world.h"
@@ -26,11 +28,10 @@ WayMatrix::WayMatrix(World &world, const zenkit::WayNet& dat)
     }
 
   edges = dat.edges;
-  stk[0].reserve(256);
-  stk[1].reserve(256);
   }
 
 void WayMatrix::buildIndex() {
+  invalidatePathCache();
   indexPoints.clear();
   adjustWaypoints(wayPoints);
   adjustWaypoints(freePoints);
@@ -57,6 +58,7 @@ void WayMatrix::buildIndex() {
     }
 
   calculateLadderPoints();
+  buildHierarchy();
   }
 
 const WayPoint *WayMatrix::findWayPoint(const Vec3& at, const std::function<bool(const WayPoint&)>& filter) const {
@@ -229,6 +231,14 @@ void WayMatrix::calculateLadderPoints() {
     }
   }
 
+void WayMatrix::buildHierarchy() {
+  const uint64_t hash = WayHierarchy::hashOf(wayPoints);
+  if(hierarchy.load(world.name(),hash,wayPoints))
+    return;
+  hierarchy.build(wayPoints);
+  hierarchy.save(world.name(),hash);
+  }
+
 const WayMatrix::FpIndex &WayMatrix::findFpIndex(std::string_view name) const {
   auto it = std::lower_bound(fpIndex.begin(),fpIndex.end(),name,[](FpIndex& l, std::string_view r){
     return l.key<r;
@@ -282,12 +292,63 @@ const WayPoint *WayMatrix::findFreePoint(float x, float y, float z, const FpInde
   return ret;
   }
 
+uint32_t WayMatrix::pointId(const WayPoint& p) const {
+  if(wayPoints.empty())
+    return uint32_t(-1);
+  intptr_t id = std::distance<const WayPoint*>(&wayPoints[0],&p);
+  if(id<0 || size_t(id)>=wayPoints.size())
+    return uint32_t(-1);
+  return uint32_t(id);
+  }
+
+uint64_t WayMatrix::pathKey(const std::vector<uint32_t>& begin, uint32_t end) {
+  uint64_t h = Fnv::hash(begin.data(),begin.size()*sizeof(begin[0]));
+  return Fnv::hash(&end,sizeof(end),h);
+  }
+
+bool WayMatrix::findCachedPath(const std::vector<uint32_t>& begin, uint32_t end, WayPath& path) const {
+  std::lock_guard<std::mutex> guard(pathSync);
+  auto it = pathCacheIndex.find(pathKey(begin,end));
+  if(it==pathCacheIndex.end() || it->second->end!=end || it->second->begin!=begin)
+    return false;
+  pathCache.splice(pathCache.begin(),pathCache,it->second);
+  path = it->second->path;
+  return true;
+  }
+
+void WayMatrix::storeCachedPath(const std::vector<uint32_t>& begin, uint32_t end, const WayPath& path) const {
+  const uint64_t key = pathKey(begin,end);
+
+  std::lock_guard<std::mutex> guard(pathSync);
+  auto it = pathCacheIndex.find(key);
+  if(it!=pathCacheIndex.end()) {
+    // same set or hash collision: newest wins
+    pathCache.splice(pathCache.begin(),pathCache,it->second);
+    it->second->begin = begin;
+    it->second->end   = end;
+    it->second->path  = path;
+    return;
+    }
+  if(pathCache.size()>=PathCacheSize) {
+    pathCacheIndex.erase(pathCache.back().key);
+    pathCache.pop_back();
+    }
+  pathCache.push_front(PathCacheItem{key,begin,end,path});
+  pathCacheIndex[key] = pathCache.begin();
+  }
+
+void WayMatrix::invalidatePathCache() {
+  std::lock_guard<std::mutex> guard(pathSync);
+  pathCache.clear();
+  pathCacheIndex.clear();
+  }
+
 WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const {
   if(beginSz==0)
     return WayPath();
 
-  intptr_t endId = std::distance<const WayPoint*>(&wayPoints[0],&end);
-  if(endId<0 || size_t(endId)>=wayPoints.size()){
+  const uint32_t endId = pointId(end);
+  if(endId==uint32_t(-1)) {
     if(end.name.find("FP_")==0) {
       WayPath ret;
       ret.add(end);
@@ -296,75 +357,138 @@ WayPath WayMatrix::wayTo(const WayPoint** begin, size_t beginSz, const Tempest::
     return WayPath();
     }
 
-  pathGen++;
-  if(pathGen==1){
-    // new cycle
-    for(auto& i:wayPoints)
-      i.pathGen=0;
+  std::vector<uint32_t> beginId;
+  std::vector<int32_t>  beginCost;
+  beginId  .reserve(beginSz);
+  beginCost.reserve(beginSz);
+  for(size_t i=0; i<beginSz; ++i) {
+    const uint32_t id = pointId(*begin[i]);
+    if(id==uint32_t(-1))
+      continue;
+    beginId  .push_back(id);
+    beginCost.push_back(int32_t((exactBegin - begin[i]->position()).length()));
     }
+  if(beginId.empty())
+    return WayPath();
 
-  std::vector<const WayPoint*> *front=&stk[0], *back=&stk[1];
-  stk[0].clear();
-  stk[1].clear();
+  // order of candidates doesn't matter for the search, but choice of start point depends on exactBegin:
+  // quantized position goes into key, so cached path is reused only from nearly the same spot
+  std::vector<uint32_t> key = beginId;
+  std::sort(key.begin(),key.end());
+  key.erase(std::unique(key.begin(),key.end()),key.end());
+  key.push_back(uint32_t(int32_t(std::floor(exactBegin.x/float(PathCacheCell)))));
+  key.push_back(uint32_t(int32_t(std::floor(exactBegin.y/float(PathCacheCell)))));
+  key.push_back(uint32_t(int32_t(std::floor(exactBegin.z/float(PathCacheCell)))));
 
-  end.pathLen = 0;
-  end.pathGen = pathGen;
-  front->push_back(&end);
+  WayPath ret;
+  if(findCachedPath(key,endId,ret))
+    return ret;
+
+  uint32_t              first = 0;
+  int32_t               cost  = 0;
+  std::vector<uint32_t> ids;
+  if(hierarchy.findPath(beginId.data(),beginCost.data(),beginId.size(),endId,ids,first,cost)) {
+    for(auto i:ids)
+      ret.add(wayPoints[i]);
+    } else {
+    ret = findPath(beginId.data(),beginCost.data(),beginId.size(),endId,first,cost);
+    }
+  // unreachable end is cached as empty path as well
+  storeCachedPath(key,endId,ret);
+  return ret;
+  }
 
-  while(front->size()>0) {
-    bool done = true;
-    for(size_t i=0; i<beginSz; ++i)
-      if(begin[i]->pathGen!=pathGen) {
-        done = false;
-        break;
-        }
-    if(done)
+WayPath WayMatrix::findPath(const uint32_t* begin, const int32_t* beginCost, size_t beginSz, uint32_t end,
+                            uint32_t& first, int32_t& cost) const {
+  // per-thread search state: multiple npc's can plan concurrently
+  struct Context {
+    std::vector<int32_t>  g;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> visit, closed;
+    uint32_t              gen = 0;
+    std::vector<std::pair<int32_t,uint32_t>> heap;
+    };
+  static thread_local Context ctx;
+
+  const uint32_t NoParent = uint32_t(-1);
+  if(ctx.visit.size()<wayPoints.size()) {
+    ctx.g     .resize(wayPoints.size());
+    ctx.parent.resize(wayPoints.size());
+    ctx.visit .resize(wayPoints.size(),0);
+    ctx.closed.resize(wayPoints.size(),0);
+    }
+  ctx.gen++;
+  if(ctx.gen==0) {
+    // wrap-around: new cycle
+    std::fill(ctx.visit .begin(),ctx.visit .end(),0);
+    std::fill(ctx.closed.begin(),ctx.closed.end(),0);
+    ctx.gen = 1;
+    }
+  ctx.heap.clear();
+
+  const uint32_t gen    = ctx.gen;
+  const Vec3     endPos = wayPoints[end].position();
+  auto heuristic = [&](uint32_t id) {
+    return int32_t((wayPoints[id].position()-endPos).length());
+    };
+  auto cmp = [](const std::pair<int32_t,uint32_t>& a, const std::pair<int32_t,uint32_t>& b) {
+    return a.first>b.first;
+    };
+  auto push = [&](uint32_t id, int32_t g, uint32_t parent) {
+    ctx.g     [id] = g;
+    ctx.parent[id] = parent;
+    ctx.visit [id] = gen;
+    ctx.heap.emplace_back(g+heuristic(id),id);
+    std::push_heap(ctx.heap.begin(),ctx.heap.end(),cmp);
+    };
+
+  for(size_t i=0; i<beginSz; ++i) {
+    const uint32_t id = begin[i];
+    if(ctx.visit[id]!=gen || beginCost[i]<ctx.g[id])
+      push(id,beginCost[i],NoParent);
+    }
+
+  bool found = false;
+  while(!ctx.heap.empty()) {
+    std::pop_heap(ctx.heap.begin(),ctx.heap.end(),cmp);
+    const uint32_t id = ctx.heap.back().second;
+    ctx.heap.pop_back();
+    if(ctx.closed[id]==gen)
+      continue;
+    ctx.closed[id] = gen;
+    if(id==end) {
+      found = true;
       break;
+      }
 
-    for(auto& wp:*front) {
-      int32_t l0 = wp->pathLen;
-
-      for(auto i:wp->connections()){
-        auto& w  = *i.point;
-        int32_t l1 = l0+i.len;
-        if(w.pathGen!=pathGen || w.pathLen>l1){
-          w.pathLen = l1;
-          w.pathGen = pathGen;
-          back->push_back(&w);
-          }
-        }
+    const int32_t g0 = ctx.g[id];
+    for(auto& i:wayPoints[id].connections()) {
+      const uint32_t next = pointId(*i.point);
+      if(next==uint32_t(-1) || ctx.closed[next]==gen)
+        continue;
+      const int32_t g1 = g0+i.len;
+      if(ctx.visit[next]!=gen || g1<ctx.g[next])
+        push(next,g1,id);
       }
-    std::swap(front,back);
-    back->clear();
     }
 
-  const WayPoint* first = begin[0];
-  for(size_t i=0; i<beginSz; ++i) {
-    int32_t iLen = begin[i]->pathLen + int((exactBegin - begin[i]->position()).length());
-    int32_t fLen = first   ->pathLen + int((exactBegin - first   ->position()).length());
-    if(iLen<fLen)
-      first = begin[i];
+  if(!found) {
+    first = NoParent;
+    cost  = -1;
+    return WayPath();
     }
 
-  WayPath ret;
-  ret.add(*first);
-  const WayPoint* current = first;
-  while(current!=&end) {
-    int32_t l0 = current->pathLen, l1=l0;
-
-    const WayPoint* next=nullptr;
-    for(auto i:current->connections()){
-      if(i.point->pathGen==pathGen && i.point->pathLen+i.len<=l0 && i.point->pathLen<l1){
-        next = i.point;
-        l1   = i.point->pathLen;
-        }
-      }
-    if(next==nullptr)
-      return WayPath();
-    ret.add(*next);
-    current=next;
+  // path is stored from end to begin; WayPath::pop returns nearest point first
+  WayPath  ret;
+  uint32_t at = end;
+  while(true) {
+    ret.add(wayPoints[at]);
+    if(ctx.parent[at]==NoParent)
+      break;
+    at = ctx.parent[at];
     }
 
-  ret.reverse();
+  first = at;
+  cost  = ctx.g[end] - ctx.g[at];
   return ret;
   }
@@ -6,10 +6,14 @@
 #include <zenkit/world/WayNet.hh>
 
 #include <vector>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <functional>
 
 #include "waypath.h"
 #include "waypoint.h"
+#include "wayhierarchy.h"
 
 class World;
 class DbgPainter;
@@ -32,9 +36,18 @@ class WayMatrix final {
     const WayPoint* findPoint(std::string_view name, bool inexact) const;
     void            marchPoints(DbgPainter& p) const;
 
+    // thread-safe; no state is stored in WayPoint
     WayPath         wayTo(const WayPoint** begin, size_t beginSz, const Tempest::Vec3 exactBegin, const WayPoint& end) const;
 
   private:
+    enum { PathCacheSize = 1024, PathCacheCell = 100 };
+    // keyed by whole set of start points: World::wayTo passes nearest point and its visible neighbours
+    struct PathCacheItem {
+      uint64_t              key = 0;
+      std::vector<uint32_t> begin; // sorted start points, followed by PathCacheCell-quantized exact position
+      uint32_t              end = 0;
+      WayPath               path;
+      };
     World&                 world;
     float                  distanceThreshold = 20.f*100.f;
 
@@ -52,11 +65,23 @@ class WayMatrix final {
       };
     mutable std::vector<FpIndex>          fpIndex;
 
-    mutable uint16_t                      pathGen=0;
-    mutable std::vector<const WayPoint*>  stk[2];
+    WayHierarchy                          hierarchy;
+
+    mutable std::mutex                    pathSync;
+    mutable std::list<PathCacheItem>      pathCache;
+    mutable std::unordered_map<uint64_t,std::list<PathCacheItem>::iterator> pathCacheIndex;
+
+    uint32_t               pointId(const WayPoint& p) const;
+    static uint64_t        pathKey(const std::vector<uint32_t>& begin, uint32_t end);
+    bool                   findCachedPath(const std::vector<uint32_t>& begin, uint32_t end, WayPath& path) const;
+    void                   storeCachedPath(const std::vector<uint32_t>& begin, uint32_t end, const WayPath& path) const;
+    void                   invalidatePathCache();
+    WayPath                findPath(const uint32_t* begin, const int32_t* beginCost, size_t beginSz, uint32_t end,
+                                    uint32_t& first, int32_t& cost) const;
 
     void                   adjustWaypoints(std::vector<WayPoint> &wp);
     void                   calculateLadderPoints();
+    void                   buildHierarchy();
 
     const FpIndex&         findFpIndex(std::string_view name) const;
     const WayPoint*        findFreePoint(float x, float y, float z, const FpIndex &ind,
@@ -1,9 +1,13 @@
 #include "world.h"
 
 #include <functional>
-#include <future>
+#include <algorithm>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
 #include <cctype>
 
+#include <Tempest/Application>
 #include <Tempest/Log>
 #include <Tempest/Painter>
 
@@ -18,6 +22,8 @@
 #include "game/globaleffects.h"
 #include "game/serialize.h"
 #include "utils/string_frm.h"
+#include "utils/fileext.h"
+#include "utils/workers.h"
 #include "gothic.h"
 #include "focus.h"
 #include "resources.h"
@@ -63,6 +69,50 @@ const char* materialTag(zenkit::MaterialGroup src) {
   return "UD";
   }
 
+// resources, that Vob::load will request for a subtree: meshes with physics shapes, decals and particles;
+// 'claim' returns false, if name is taken by another task already
+template<class Claim>
+static void resolveVobTree(const zenkit::VirtualObject& vob, bool deep, Claim& claim) {
+  if(vob.visual!=nullptr && !vob.visual->name.empty()) {
+    try {
+      switch(vob.visual->type) {
+        case zenkit::VisualType::MESH:
+        case zenkit::VisualType::MULTI_RESOLUTION_MESH:
+          if(claim(vob.visual->name))
+            Resources::loadMesh(vob.visual->name);
+          break;
+        case zenkit::VisualType::MODEL:
+        case zenkit::VisualType::MORPH_MESH: {
+          auto visual = vob.visual->name;
+          FileExt::exchangeExt(visual,"ASC","MDL");
+          if(claim(visual))
+            Resources::loadMesh(visual);
+          break;
+          }
+        case zenkit::VisualType::DECAL:
+          if(auto decal = dynamic_cast<const zenkit::VisualDecal*>(vob.visual.get())) {
+            if(vob.sprite_camera_facing_mode==zenkit::SpriteAlignment::NONE)
+              Resources::decalMesh(*decal);
+            }
+          break;
+        case zenkit::VisualType::PARTICLE_EFFECT:
+          if(claim(vob.visual->name))
+            Gothic::inst().loadParticleFx(vob.visual->name);
+          break;
+        default:
+          break;
+        }
+      }
+    catch(...) {
+      // reported again, when vob is created
+      }
+    }
+  if(!deep)
+    return;
+  for(auto& i:vob.children)
+    resolveVobTree(*i,deep,claim);
+  }
+
 World::World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress)
   :wname(std::move(file)), game(game), wsound(game,*this), wobj(*this) {
   const auto* entry = Resources::vdfsIndex().find(wname);
@@ -72,26 +122,87 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
     return;
     }
 
+  const uint64_t time0     = Tempest::Application::tickCount();
+  uint64_t       timeStage = time0;
+  auto stage = [&](const char* name, int progress) {
+    const uint64_t t = Tempest::Application::tickCount();
+    Tempest::Log::i("world \"",wname,"\" ",name,": ",t-timeStage,"ms");
+    timeStage = t;
+    loadProgress(progress);
+    };
+
   try {
-    auto          buf = entry->open_read();
+    auto          buf = Resources::getFileBuffer(wname);
     zenkit::World world;
     world.load(buf.get(), version().game == 1 ? zenkit::GameVersion::GOTHIC_1
                                               : zenkit::GameVersion::GOTHIC_2);
+    stage("parse",20);
 
-    loadProgress(20);
     auto& worldMesh = world.world_mesh;
 
-    auto wdynamicFut = std::async(std::launch::async, [&]() {
-      Workers::setThreadName("Loading: BVH thread");
-      return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh));
+    // vob subtrees: big roots (level-vobs) are split into child subtrees, to balance the pool
+    struct VobTree {
+      const zenkit::VirtualObject* vob  = nullptr;
+      bool                         deep = true;
+      };
+    std::vector<VobTree> vobTrees;
+    for(auto& vob:world.world_vobs) {
+      const bool split = vob->children.size()>=64;
+      vobTrees.push_back({vob.get(),!split});
+      if(split) {
+        for(auto& i:vob->children)
+          vobTrees.push_back({i.get(),true});
+        }
+      }
+
+    // exceptions are collected per task and rethrown on loading thread
+    std::exception_ptr errDynamic, errView, errWay;
+
+    Workers::TaskGroup dynamicTask, viewTask, wayTask, assetTask;
+    dynamicTask.run([&]() {
+      try {
+        wdynamic.reset(new DynamicWorld(*this,worldMesh));
+        }
+      catch(...) {
+        errDynamic = std::current_exception();
+        }
       });
-    auto wviewFut = std::async(std::launch::async, [&]() {
-      Workers::setThreadName("Loading: PackedMesh thread");
-      PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd);
-      return std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
+    viewTask.run([&]() {
+      try {
+        PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd,wname);
+        wview.reset(new WorldView(*this,vmesh));
+        }
+      catch(...) {
+        errView = std::current_exception();
+        }
+      });
+    wayTask.run([&]() {
+      try {
+        wmatrix.reset(new WayMatrix(*this,world.world_way_net));
+        }
+      catch(...) {
+        errWay = std::current_exception();
+        }
       });
 
-    loadProgress(30);
+    std::mutex                      claimSync;
+    std::unordered_set<std::string> claimed;
+    auto claim = [&](std::string_view name) {
+      std::lock_guard<std::mutex> guard(claimSync);
+      return claimed.emplace(name).second;
+      };
+    const uint64_t        vobStart = Tempest::Application::tickCount();
+    std::atomic<uint64_t> vobEnd{vobStart};
+    for(auto& i:vobTrees) {
+      assetTask.run([&claim,&vobEnd,tree=i]() {
+        resolveVobTree(*tree.vob,tree.deep,claim);
+        const uint64_t t = Tempest::Application::tickCount();
+        uint64_t       e = vobEnd.load();
+        while(e<t && !vobEnd.compare_exchange_weak(e,t))
+          ;
+        });
+      }
+    stage("schedule",30);
 
     {
       bsp.nodes             = std::move(world.world_bsp_tree.nodes);
@@ -100,21 +211,36 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
       bsp.sectorsData.resize(bsp.sectors.size());
       world.world_bsp_tree  = zenkit::BspTree();
     }
-    loadProgress(50);
-
-    wview = wviewFut.get();
-    loadProgress(60);
-
-    wdynamic = wdynamicFut.get();
-    loadProgress(70);
-
+    stage("bsp",40);
+
+    viewTask.wait();
+    if(errView)
+      std::rethrow_exception(errView);
+    stage("view",50);
+
+    dynamicTask.wait();
+    if(errDynamic)
+      std::rethrow_exception(errDynamic);
+    stage("physics",60);
+
+    wayTask.wait();
+    if(errWay)
+      std::rethrow_exception(errWay);
+    assetTask.wait();
+    Tempest::Log::i("world \"",wname,"\" vob subtrees: ",vobEnd.load()-vobStart,"ms, ",vobTrees.size()," tasks");
+    stage("vob resources",80);
+
+    // scene-graph is mutated only from loading thread; resources of subtrees are resolved by now
     globFx.reset(new GlobalEffects(*this));
-    wmatrix.reset(new WayMatrix(*this,world.world_way_net));
     for(auto& vob:world.world_vobs)
       wobj.addRoot(vob,startup);
+    wobj.captureBaseline();
+    stage("vobs",95);
 
     wmatrix->buildIndex();
-    loadProgress(100);
+    stage("waynet",100);
+
+    Tempest::Log::i("world \"",wname,"\" loaded: ",Tempest::Application::tickCount()-time0,"ms");
     }
   catch(...) {
     Tempest::Log::e("unable to load landscape mesh");
@@ -285,6 +411,19 @@ void World::updateAnimation(uint64_t dt) {
   wobj.updateAnimation(dt);
   }
 
+void World::snapshot(RenderSnapshot& dst) {
+  wobj.snapshot(dst);
+  if(auto pl = player()) {
+    dst.camera[0] = pl->cameraBone(false);
+    dst.camera[1] = pl->cameraBone(true);
+    dst.hasCamera = true;
+    }
+  }
+
+bool World::applySnapshot(const RenderSnapshot& snap, const std::vector<Tempest::Matrix4x4>& tr) {
+  return wobj.applySnapshot(snap,tr);
+  }
+
 void World::resetPositionToTA() {
   wobj.resetPositionToTA();
   }
@@ -807,6 +946,22 @@ void World::invalidateVobIndex() {
   wobj.invalidateVobIndex();
   }
 
+void World::updateVobIndex(const Vob& vob) {
+  wobj.updateVobIndex(vob);
+  }
+
+void World::updateNpcIndex(const Npc& npc) {
+  wobj.updateNpcIndex(npc);
+  }
+
+bool World::testLos(const Npc& src, const Npc& dst, uint8_t point, const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  return wobj.testLos(src,dst,point,from,to);
+  }
+
+void World::requestLos(const Npc& src, const Npc& dst, uint8_t point, const Tempest::Vec3& from, const Tempest::Vec3& to) {
+  wobj.requestLos(src,dst,point,from,to);
+  }
+
 const zenkit::IFocus& World::searchPolicy(const Npc& pl, TargetCollect& coll, WorldObjects::SearchFlg& opt) const {
   opt  = WorldObjects::NoFlg;
   coll = TARGET_COLLECT_FOCUS;
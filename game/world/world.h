@@ -100,6 +100,9 @@ class World final {
     MeshObjects::Mesh    addDecalView (const zenkit::VisualDecal& decal);
 
     void                 updateAnimation(uint64_t dt);
+    void                 snapshot(RenderSnapshot& dst);
+    bool                 applySnapshot(const RenderSnapshot& snap, const std::vector<Tempest::Matrix4x4>& tr);
+    auto                 animLodStats() const -> const uint32_t* { return wobj.animLodStats(); }
     void                 resetPositionToTA();
 
     auto                 takeHero() -> std::unique_ptr<Npc>;
@@ -180,6 +183,11 @@ class World final {
     void                 addSound      (const zenkit::VirtualObject& vob);
 
     void                 invalidateVobIndex();
+    void                 updateVobIndex(const Vob& vob);
+    void                 updateNpcIndex(const Npc& npc);
+
+    bool                 testLos   (const Npc& src, const Npc& dst, uint8_t point, const Tempest::Vec3& from, const Tempest::Vec3& to);
+    void                 requestLos(const Npc& src, const Npc& dst, uint8_t point, const Tempest::Vec3& from, const Tempest::Vec3& to);
 
   private:
     const zenkit::IFocus& searchPolicy(const Npc& pl, TargetCollect& coll, WorldObjects::SearchFlg& opt) const;
@@ -11,8 +11,11 @@
 #include "world/triggers/triggerworldstart.h"
 #include "world/triggers/abstracttrigger.h"
 #include "world.h"
+#include "graphics/dynamic/frustrum.h"
+#include "graphics/rendersnapshot.h"
 #include "utils/workers.h"
 #include "utils/dbgpainter.h"
+#include "utils/profiler.h"
 #include "gothic.h"
 
 #include <Tempest/Painter>
@@ -58,6 +61,23 @@ WorldObjects::SearchOpt::SearchOpt(float rangeMin, float rangeMax, float azi, Ta
   :rangeMin(rangeMin),rangeMax(rangeMax),azi(azi),collectAlgo(collectAlgo),flags(flags) {
   }
 
+std::vector<uint8_t> WorldObjects::itemState(const Item& it) const {
+  Serialize::Snapshot snap;
+  {
+  Serialize s(snap);
+  s.setContext(&owner);
+  s.setEntry("item");
+  it.save(s);
+  }
+  return snap.bytes();
+  }
+
+std::string_view WorldObjects::itemInstance(const Item& it) const {
+  if(auto sym = owner.script().findSymbol(it.handle().symbol_index()))
+    return sym->name();
+  return "";
+  }
+
 WorldObjects::WorldObjects(World& owner):owner(owner){
   npcNear.reserve(512);
   }
@@ -72,18 +92,27 @@ void WorldObjects::load(Serialize &fin) {
   fin.read(v);
   fin.setVersion(v);
   }
-  itemArr.clear();
-  items.clear();
+  if(fin.version()<50) {
+    itemArr.clear();
+    items.clear();
+    }
 
   uint32_t sz = fin.directorySize("worlds/",fin.worldName(),"/npc/");
   npcArr.resize(sz);
   for(size_t i=0; i<sz; ++i)
     npcArr[i] = std::make_unique<Npc>(owner,size_t(-1),"");
+  npcIndex.clear();
+  npcActive.clear();
+  npcNear.clear();
   for(size_t i=0; i<npcArr.size(); ++i) {
     npcArr[i]->load(fin,i);
+    npcIndex.insert(npcArr[i].get(),npcArr[i]->position());
+    npcActive.push_back(npcArr[i].get());
     }
 
   fin.setEntry("worlds/",fin.worldName(),"/items");
+  if(fin.version()>=50)
+    loadZenItems(fin);
   fin.read(sz);
   for(size_t i=0; i<sz; ++i) {
     auto it = std::make_unique<Item>(owner,fin,Item::T_World);
@@ -112,6 +141,70 @@ void WorldObjects::load(Serialize &fin) {
     i->postValidate();
   }
 
+void WorldObjects::loadZenItems(Serialize& fin) {
+  // unchanged *.zen items: keep ones listed in save, drop the rest (picked up or changed)
+  std::vector<Item*> zen(zenItemBase.size());
+  for(auto& i:itemArr)
+    if(i->zenIndex()<zen.size())
+      zen[i->zenIndex()] = i.get();
+  std::vector<bool> keep(zen.size());
+
+  uint32_t zenCount = 0;
+  if(fin.version()<51) {
+    std::vector<uint32_t> zenKeep;
+    fin.read(zenCount,zenKeep);
+    if(zenCount!=zen.size()) {
+      // *.zen was changed since save; keep world as constructed
+      Tempest::Log::e("world items are inconsistent with savegame: \"",fin.worldName(),"\"");
+      return;
+      }
+    for(auto id:zenKeep)
+      if(id<keep.size())
+        keep[id] = true;
+    } else {
+    // match by index, then by instance and position, if *.zen was changed since save
+    std::unordered_multimap<std::string_view,uint32_t> byName;
+    uint32_t      keepCount = 0;
+    std::string   name;
+    Tempest::Vec3 pos;
+    fin.read(zenCount,keepCount);
+    for(uint32_t i=0; i<keepCount; ++i) {
+      uint32_t id = 0;
+      fin.read(id,name,pos);
+      auto match = [&](uint32_t r) {
+        auto it = zen[r];
+        return !keep[r] && itemInstance(*it)==name && (it->position()-pos).quadLength()<1.f;
+        };
+      if(zenCount==zen.size() && id<zen.size() && zen[id]!=nullptr && match(id)) {
+        keep[id] = true;
+        continue;
+        }
+      if(byName.empty()) {
+        for(uint32_t r=0; r<zen.size(); ++r)
+          if(zen[r]!=nullptr)
+            byName.emplace(itemInstance(*zen[r]),r);
+        }
+      auto range = byName.equal_range(name);
+      for(auto r=range.first; r!=range.second; ++r)
+        if(match(r->second)) {
+          keep[r->second] = true;
+          break;
+          }
+      }
+    }
+
+  for(size_t i=0; i<itemArr.size();) {
+    auto id = itemArr[i]->zenIndex();
+    if(id<keep.size() && keep[id]) {
+      ++i;
+      continue;
+      }
+    items.del(itemArr[i].get());
+    itemArr[i] = std::move(itemArr.back());
+    itemArr.pop_back();
+    }
+  }
+
 void WorldObjects::save(Serialize &fout) {
   fout.setEntry("worlds/",fout.worldName(),"/version");
   fout.write(Serialize::Version::Current);
@@ -120,10 +213,22 @@ void WorldObjects::save(Serialize &fout) {
     npcArr[i]->save(fout,i);
     }
 
+  // items from *.zen, that are unchanged since construction, are stored by reference only
+  std::vector<const Item*> zenKeep;
+  std::vector<const Item*> modified;
+  for(auto& i:itemArr) {
+    auto id = i->zenIndex();
+    if(id<zenItemBase.size() && zenItemBase[id]==itemState(*i))
+      zenKeep.push_back(i.get()); else
+      modified.push_back(i.get());
+    }
+
   fout.setEntry("worlds/",fout.worldName(),"/items");
-  uint32_t sz = uint32_t(itemArr.size());
-  fout.write(sz);
-  for(auto& i:itemArr)
+  fout.write(uint32_t(zenItemBase.size()),uint32_t(zenKeep.size()));
+  for(auto i:zenKeep)
+    fout.write(i->zenIndex(),itemInstance(*i),i->position());
+  fout.write(uint32_t(modified.size()));
+  for(auto i:modified)
     i->save(fout);
 
   fout.setEntry("worlds/",fout.worldName(),"/mobsi");
@@ -142,6 +247,7 @@ void WorldObjects::save(Serialize &fout) {
   }
 
 void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
+  Profiler::Zone zone("WorldObjects::tick");
   auto passive=std::move(sndPerc);
   sndPerc.clear();
 
@@ -164,12 +270,16 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   auto       camera  = Gothic::inst().camera();
   const bool freeCam = (camera!=nullptr && camera->isFree());
   const auto pl      = owner.player();
-  for(size_t i=0; i<npcArr.size(); ++i) {
-    auto& npc = *npcArr[i];
-    uint64_t d = (pl==&npc ? dtPlayer : dt);
-    if(freeCam && pl==&npc)
-      continue;
-    npc.tick(d);
+  if(Gothic::inst().isParallelNpcTick()) {
+    tickNpcParallel(dt,dtPlayer,freeCam);
+    } else {
+    for(size_t i=0; i<npcArr.size(); ++i) {
+      auto& npc = *npcArr[i];
+      uint64_t d = (pl==&npc ? dtPlayer : dt);
+      if(freeCam && pl==&npc)
+        continue;
+      npc.tick(d);
+      }
     }
 
   for(auto& i:routines) {
@@ -204,30 +314,14 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
   if(pl==nullptr)
     return;
 
-  npcNear.clear();
-  //const int   PERC_DIST_INTERMEDIAT = 1000;
-  const float nearDist              = 3000*3000;
-  const float farDist               = 6000*6000;
-
-  auto plPos = pl->position();
-  for(auto& i:npcArr) {
-    float dist = (i->position()-plPos).quadLength();
-    if(dist<nearDist){
-      npcNear.push_back(i.get());
-      if(i.get()!=pl)
-        i->setProcessPolicy(Npc::ProcessPolicy::AiNormal);
-      } else
-    if(dist<farDist) {
-      i->setProcessPolicy(Npc::ProcessPolicy::AiFar);
-      } else {
-      i->setProcessPolicy(Npc::ProcessPolicy::AiFar2);
-      }
-    }
+  classifyNpc(*pl,camera!=nullptr ? camera->destPosition() : pl->position());
   tickNear(dt);
   for(CollisionZone* z:collisionZn)
     z->tick(dt);
   tickTriggers(dt);
 
+  tickLos(*pl);
+
   for(auto& ptr:npcNear) {
     Npc& i = *ptr;
     if(i.isPlayer() || i.isDead())
@@ -245,6 +339,77 @@ void WorldObjects::tick(uint64_t dt, uint64_t dtPlayer) {
     }
   }
 
+void WorldObjects::classifyNpc(Npc& pl, const Vec3& camPos) {
+  //const int   PERC_DIST_INTERMEDIAT = 1000;
+  const float nearDist              = 3000;
+  const float farDist               = 6000;
+
+  // anything out of farDist around player and camera is AiFar2:
+  // demote npc's, that were closer on last tick, and promote ones found in index
+  for(auto i:npcActive)
+    if(i!=&pl)
+      i->setProcessPolicy(Npc::ProcessPolicy::AiFar2);
+  npcActive.clear();
+  npcNear.clear();
+
+  const Vec3 plPos = pl.position();
+  auto classify = [&](void* ptr) {
+    auto& npc = *reinterpret_cast<Npc*>(ptr);
+    if(&npc==&pl || npc.processPolicy()!=Npc::ProcessPolicy::AiFar2)
+      return;
+    const float dPl  = (npc.position()-plPos).quadLength();
+    const float dist = std::min(dPl,(npc.position()-camPos).quadLength());
+    if(dPl<nearDist*nearDist)
+      npcNear.push_back(&npc);
+    if(dist<nearDist*nearDist)
+      npc.setProcessPolicy(Npc::ProcessPolicy::AiNormal); else
+      npc.setProcessPolicy(Npc::ProcessPolicy::AiFar);
+    npcActive.push_back(&npc);
+    };
+  npcIndex.find(plPos,farDist,classify);
+  if(camPos!=plPos)
+    npcIndex.find(camPos,farDist,classify);
+
+  // previous player is demoted, once control goes to other npc
+  npcActive.push_back(&pl);
+  npcNear  .push_back(&pl);
+  // same order as npcArr: perception and search results don't depend on hash layout
+  std::sort(npcNear.begin(),npcNear.end(),[](const Npc* a, const Npc* b){
+    return a->handle().id<b->handle().id;
+    });
+  }
+
+void WorldObjects::tickNpcParallel(uint64_t dt, uint64_t dtPlayer, bool freeCam) {
+  const auto   pl    = owner.player();
+  const size_t count = npcArr.size();
+  const size_t tasks = std::min<size_t>(Workers::maxThreads()+1, (count+15)/16);
+  if(tasks==0)
+    return;
+
+  // ray queries of MoveAlgo::prefetch are reentrant, while aabbs are not touched
+  owner.physic()->updateAabbs();
+  npcCmd.resize(tasks);
+  {
+  Profiler::Zone zone("WorldObjects::tickNpcParallel");
+  Workers::parallelTasks(tasks,[&](size_t id){
+    // contiguous range per task: buffers in task order are in npc order
+    NpcCommands::Scope scope(npcCmd[id]);
+    for(size_t i=count*id/tasks; i<count*(id+1)/tasks; ++i) {
+      auto&    npc = *npcArr[i];
+      uint64_t d   = (pl==&npc ? dtPlayer : dt);
+      if(freeCam && pl==&npc)
+        continue;
+      npc.tickPrepare(d);
+      npcCmd[id].push([&npc,d](){ npc.tickAi(d); });
+      }
+    });
+  }
+
+  Profiler::Zone zone("WorldObjects::replayNpc");
+  for(auto& i:npcCmd)
+    i.replay();
+  }
+
 uint32_t WorldObjects::npcId(const Npc *ptr) const {
   if(ptr==nullptr)
     return uint32_t(-1);
@@ -301,12 +466,15 @@ Npc* WorldObjects::addNpc(size_t npcInstance, std::string_view at) {
     npc->attachToPoint(pos);
     npc->updateTransform();
     npcArr.emplace_back(npc);
+    npcIndex.insert(npc,npc->position());
+    npcActive.push_back(npc);
     } else {
     auto& point = owner.deadPoint();
     npc->attachToPoint(nullptr);
     npc->setPosition(point.position());
     npc->updateTransform();
     npcInvalid.emplace_back(npc);
+    npcActive.push_back(npc);
     }
 
   return npc;
@@ -319,6 +487,8 @@ Npc* WorldObjects::addNpc(size_t npcInstance, const Vec3& pos) {
   npc->updateTransform();
 
   npcArr.emplace_back(npc);
+  npcIndex.insert(npc,npc->position());
+  npcActive.push_back(npc);
   return npc;
   }
 
@@ -340,6 +510,8 @@ Npc* WorldObjects::insertPlayer(std::unique_ptr<Npc> &&npc, std::string_view at)
   npc->attachToPoint(pos);
   npc->updateTransform();
   npcArr.emplace_back(std::move(npc));
+  npcIndex.insert(npcArr.back().get(),npcArr.back()->position());
+  npcActive.push_back(npcArr.back().get());
   return npcArr.back().get();
   }
 
@@ -350,12 +522,109 @@ std::unique_ptr<Npc> WorldObjects::takeNpc(const Npc* ptr) {
       auto ret=std::move(npcArr[i]);
       npcArr[i] = std::move(npcArr.back());
       npcArr.pop_back();
+      npcIndex.erase(ret.get());
+      npcActive.erase(std::remove(npcActive.begin(),npcActive.end(),ptr),npcActive.end());
+      npcNear  .erase(std::remove(npcNear  .begin(),npcNear  .end(),ptr),npcNear  .end());
+      losCache.clear();
       return ret;
       }
     }
   return nullptr;
   }
 
+size_t WorldObjects::LosKeyHash::operator()(const LosKey& k) const {
+  const size_t a = std::hash<const void*>()(k.src);
+  const size_t b = std::hash<const void*>()(k.dst);
+  return (a*31 + b)*4 + k.point;
+  }
+
+bool WorldObjects::testLos(const Npc& src, const Npc& dst, uint8_t point, const Vec3& from, const Vec3& to) {
+  const LosKey   key = {&src,&dst,point};
+  const uint64_t now = owner.tickCount();
+  if(auto it = losCache.find(key); it!=losCache.end() && now<it->second.time+LosCacheTime)
+    return !it->second.blocked;
+  const bool blocked = owner.physic()->ray(from,to).hasCol;
+  losCache[key] = LosEntry{now,blocked};
+  return !blocked;
+  }
+
+void WorldObjects::requestLos(const Npc& src, const Npc& dst, uint8_t point, const Vec3& from, const Vec3& to) {
+  const LosKey key = {&src,&dst,point};
+  if(auto it = losCache.find(key); it!=losCache.end() && owner.tickCount()<it->second.time+LosCacheTime)
+    return;
+  if(!losQueued.insert(key).second)
+    return;
+  losPending.push_back(LosRequest{key,from,to});
+  }
+
+void WorldObjects::tickLos(Npc& pl) {
+  const uint64_t now = owner.tickCount();
+  std::erase_if(losCache,[now](const auto& i){
+    return i.second.time+LosCacheTime<=now;
+    });
+
+  // npc's, that run perception in this frame
+  losObservers.clear();
+  for(auto& ptr:npcNear) {
+    Npc& i = *ptr;
+    if(!i.isPlayer() && !i.isDead() && i.percNextTime()<=now)
+      losObservers.push_back(ptr);
+    }
+  if(losObservers.empty())
+    return;
+  std::sort(losObservers.begin(),losObservers.end());
+
+  auto isObserver = [this](const Npc* n) {
+    return std::binary_search(losObservers.begin(),losObservers.end(),n);
+    };
+
+  // every unordered pair is visited once: pair of two observers is left to the lower address,
+  // if it's in range of that one
+  for(auto a:losObservers) {
+    const Vec3  pos   = a->position();
+    const float range = float(a->handle().senses_range);
+    detectNpc(pos.x,pos.y,pos.z,range,[&](Npc& b){
+      if(&b==a)
+        return;
+      const bool  both = isObserver(&b);
+      const float rb   = float(b.handle().senses_range);
+      if(both && &b<a && (b.position()-pos).quadLength()<rb*rb)
+        return;
+      a->prefetchPerception(b,pl);
+      if(both)
+        b.prefetchPerception(*a,pl);
+      });
+    }
+
+  traceLos(now);
+
+  // mid-point blocked: scripts will follow up with canSeeNpc, that tests physical center and head
+  const size_t midCount = losPending.size();
+  for(size_t i=0; i<midCount; ++i) {
+    const LosKey key = losPending[i].key;
+    if(losCache[key].blocked)
+      key.src->prefetchSeeNpc(*key.dst);
+    }
+  losPending.erase(losPending.begin(),losPending.begin()+ptrdiff_t(midCount));
+  traceLos(now);
+
+  losPending.clear();
+  losQueued.clear();
+  }
+
+void WorldObjects::traceLos(uint64_t now) {
+  if(losPending.empty())
+    return;
+
+  std::vector<DynamicWorld::LosRay> rays(losPending.size());
+  for(size_t i=0; i<losPending.size(); ++i)
+    rays[i] = DynamicWorld::LosRay{losPending[i].from,losPending[i].to};
+
+  const auto mask = owner.physic()->losBatch(rays.data(),rays.size());
+  for(size_t i=0; i<losPending.size(); ++i)
+    losCache[losPending[i].key] = LosEntry{now,(mask[i/64] & (uint64_t(1) << (i%64)))!=0};
+  }
+
 void WorldObjects::tickNear(uint64_t /*dt*/) {
   for(Npc* i:npcNear) {
     auto pos = i->position() + Vec3(0,i->translateY(),0);
@@ -409,14 +678,93 @@ void WorldObjects::updateAnimation(uint64_t dt) {
     return;
   if(dt==0)
     return;
-  Workers::parallelTasks(npcArr,[dt](std::unique_ptr<Npc>& i){
-    i->updateAnimation(dt);
+
+  // far and off-screen skeletons are updated at reduced rate; spread over frames by index
+  Frustrum   fr;
+  auto       camera = Gothic::inst().camera();
+  const bool lod    = Gothic::inst().isAnimLod();
+  if(camera!=nullptr)
+    fr.make(camera->viewProj(),1,1);
+
+  animLod.resize(npcArr.size());
+  std::fill(std::begin(animLodCount),std::end(animLodCount),0);
+  for(size_t i=0; i<npcArr.size(); ++i) {
+    auto& npc = *npcArr[i];
+    uint8_t tier = AL_Full;
+    if(lod && !npc.isPlayer()) {
+      const bool visible = (camera==nullptr || fr.testPoint(npc.position(),250.f));
+      switch(npc.processPolicy()) {
+        case Npc::ProcessPolicy::Player:
+        case Npc::ProcessPolicy::AiNormal:
+          tier = visible ? AL_Full    : AL_Half;
+          break;
+        case Npc::ProcessPolicy::AiFar:
+          tier = visible ? AL_Half    : AL_Quarter;
+          break;
+        case Npc::ProcessPolicy::AiFar2:
+          tier = visible ? AL_Quarter : AL_Eighth;
+          break;
+        }
+      }
+    animLod[i] = tier;
+    animLodCount[tier]++;
+    }
+  animLodFrame++;
+
+  const uint64_t frame = animLodFrame;
+  Workers::parallelTasks(npcArr,[this,dt,frame](std::unique_ptr<Npc>& i){
+    const size_t   id   = size_t(&i - npcArr.data());
+    const uint64_t step = uint64_t(1) << animLod[id];
+    i->updateAnimation(dt,(frame+id)%step==0);
     });
   interactiveObj.parallelFor([dt](Interactive& i){
     i.updateAnimation(dt);
     });
   }
 
+void WorldObjects::snapshot(RenderSnapshot& dst) {
+  dst.clear();
+  for(auto& i:npcArr)
+    i->snapshot(dst);
+  for(auto& i:itemArr)
+    if(i->isDynamic())
+      i->snapshot(dst);
+  for(size_t i=0; i<interactiveObj.size(); ++i)
+    mobsi(i).snapshot(dst);
+
+  // link to previous snapshot, so render can blend by index
+  for(auto& i:dst.obj) {
+    auto it = snapIndex.find(i.owner);
+    if(it!=snapIndex.end())
+      i.prev = it->second;
+    }
+  snapIndex.clear();
+  for(size_t i=0; i<dst.obj.size(); ++i)
+    snapIndex[dst.obj[i].owner] = uint32_t(i);
+  snapId = dst.id;
+  }
+
+bool WorldObjects::applySnapshot(const RenderSnapshot& snap, const std::vector<Tempest::Matrix4x4>& tr) {
+  // owners are alive only while no logic step did run after this snapshot
+  if(snap.id!=snapId || tr.size()!=snap.tr.size())
+    return false;
+  for(auto& i:snap.obj) {
+    const Tempest::Matrix4x4* m = &tr[i.tr];
+    switch(i.type) {
+      case RenderSnapshot::T_Npc:
+        reinterpret_cast<Npc*>(i.owner)->setRenderPose(m,i.count);
+        break;
+      case RenderSnapshot::T_Item:
+        reinterpret_cast<Item*>(i.owner)->setRenderPose(m,i.count);
+        break;
+      case RenderSnapshot::T_Mobsi:
+        reinterpret_cast<Interactive*>(i.owner)->setRenderPose(m,i.count);
+        break;
+      }
+    }
+  return true;
+  }
+
 bool WorldObjects::isTargeted(Npc& dst) {
   std::atomic_flag flg = ATOMIC_FLAG_INIT;
   Workers::parallelFor(npcArr,[&dst,&flg](std::unique_ptr<Npc>& i) {
@@ -473,22 +821,27 @@ void WorldObjects::detectNpcNear(const std::function<void(Npc&)>& f) {
 
 void WorldObjects::detectNpc(const float x, const float y, const float z,
                              const float r, const std::function<void(Npc&)>& f) {
-  float maxDist=r*r;
-  for(auto& i:npcArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
-    if(qDist<maxDist)
-      f(*i);
-    }
+  const Vec3  at      = Vec3(x,y,z);
+  const float maxDist = r*r;
+  npcIndex.find(at,r,[&](void* ptr){
+    auto& npc = *reinterpret_cast<Npc*>(ptr);
+    if((npc.position()-at).quadLength()<maxDist)
+      f(npc);
+    });
   }
 
 void WorldObjects::detectItem(const float x, const float y, const float z,
                               const float r, const std::function<void(Item&)>& f) {
-  float maxDist=r*r;
-  for(auto& i:itemArr) {
-    auto qDist = (i->position()-Vec3(x,y,z)).quadLength();
-    if(qDist<maxDist)
-      f(*i);
-    }
+  const Vec3  at      = Vec3(x,y,z);
+  const float maxDist = r*r;
+  items.find(at,r,[&](Item& i){
+    if((i.position()-at).quadLength()<maxDist)
+      f(i);
+    });
+  }
+
+void WorldObjects::updateNpcIndex(const Npc& npc) {
+  npcIndex.move(&npc,npc.position());
   }
 
 void WorldObjects::addTrigger(AbstractTrigger* tg) {
@@ -696,11 +1049,26 @@ void WorldObjects::addRoot(const std::shared_ptr<zenkit::VirtualObject>& vob, bo
   rootVobs.emplace_back(std::move(p));
   }
 
+void WorldObjects::captureBaseline() {
+  zenItemBase.resize(itemArr.size());
+  for(size_t i=0; i<itemArr.size(); ++i) {
+    itemArr[i]->setZenIndex(uint32_t(i));
+    zenItemBase[i] = itemState(*itemArr[i]);
+    }
+  for(auto& i:rootVobs)
+    i->captureBaseline();
+  }
+
 void WorldObjects::invalidateVobIndex() {
   items.invalidate();
   interactiveObj.invalidate();
   }
 
+void WorldObjects::updateVobIndex(const Vob& vob) {
+  items.update(&vob);
+  interactiveObj.update(&vob);
+  }
+
 Interactive* WorldObjects::validateInteractive(Interactive *def) {
   return interactiveObj.hasObject(def) ? def : nullptr;
   }
@@ -752,7 +1120,15 @@ Npc* WorldObjects::findNpcNear(const Npc& pl, Npc* def, const SearchOpt& opt) {
     if(def && testObj(*def,pl,xopt))
       return def;
     }
-  auto r = findObj(npcNear,pl,opt);
+  npcSearch.clear();
+  npcIndex.find(pl.position(),opt.rangeMax,[this](void* ptr){
+    npcSearch.push_back(reinterpret_cast<Npc*>(ptr));
+    });
+  // ties are resolved by order: keep it independent from hash layout
+  std::sort(npcSearch.begin(),npcSearch.end(),[](const Npc* a, const Npc* b){
+    return a->handle().id<b->handle().id;
+    });
+  auto r = findObj(npcSearch,pl,opt);
   if(r!=nullptr && (!Gothic::inst().options().hideFocus || !r->isDead() ||
                        r->inventory().iterator(Inventory::T_Ransack).isValid()))
     return r;
@@ -850,6 +1226,10 @@ void WorldObjects::setMobRoutine(gtime time, std::string_view scheme, int32_t st
   }
 
 void WorldObjects::sendPassivePerc(Npc &self, Npc &other, Npc &victum, Item* itm, int32_t perc) {
+  if(auto cmd = NpcCommands::current()) {
+    cmd->push([this,&self,&other,&victum,itm,perc](){ sendPassivePerc(self,other,victum,itm,perc); });
+    return;
+    }
   PerceptionMsg m;
   m.what   = perc;
   m.pos    = self.position();
@@ -862,6 +1242,10 @@ void WorldObjects::sendPassivePerc(Npc &self, Npc &other, Npc &victum, Item* itm
   }
 
 void WorldObjects::sendImmediatePerc(Npc& self, Npc& other, Npc& victum, Item* itm, int32_t perc) {
+  if(auto cmd = NpcCommands::current()) {
+    cmd->push([this,&self,&other,&victum,itm,perc](){ sendImmediatePerc(self,other,victum,itm,perc); });
+    return;
+    }
   const auto pl = owner.player();
   if(pl==nullptr || pl->bodyStateMasked()==BS_SNEAK)
     return;
@@ -924,8 +1308,10 @@ void WorldObjects::resetPositionToTA() {
   for(auto& r:routines)
     r.curState = 0;
 
-  for(auto& i:npcInvalid)
+  for(auto& i:npcInvalid) {
+    npcIndex.insert(i.get(),i->position());
     npcArr.push_back(std::move(i));
+    }
   npcInvalid.clear();
 
   for(size_t i=0;i<npcArr.size();) {
@@ -933,6 +1319,7 @@ void WorldObjects::resetPositionToTA() {
     if(n.resetPositionToTA()){
       ++i;
       } else {
+      npcIndex.erase(npcArr[i].get());
       npcInvalid.emplace_back(std::move(npcArr[i]));
       npcArr.erase(npcArr.begin()+int(i));
 
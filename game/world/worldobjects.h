@@ -2,11 +2,14 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <zenkit/vobs/Misc.hh>
 
 #include "bullet.h"
 #include "spaceindex.h"
+#include "npccommands.h"
 #include "game/gametime.h"
 #include "game/perceptionmsg.h"
 #include "game/constants.h"
@@ -22,6 +25,7 @@ class TriggerEvent;
 class AbstractTrigger;
 class CsCamera;
 class CollisionZone;
+class RenderSnapshot;
 
 class WorldObjects final {
   public:
@@ -56,7 +60,17 @@ class WorldObjects final {
     Npc*           insertPlayer(std::unique_ptr<Npc>&& npc, std::string_view at);
     auto           takeNpc(const Npc* npc) -> std::unique_ptr<Npc>;
 
+    enum AnimLod : uint8_t {
+      AL_Full,
+      AL_Half,
+      AL_Quarter,
+      AL_Eighth,
+      AL_Count,
+      };
     void           updateAnimation(uint64_t dt);
+    auto           animLodStats() const -> const uint32_t* { return animLodCount; }
+    void           snapshot(RenderSnapshot& dst);
+    bool           applySnapshot(const RenderSnapshot& snap, const std::vector<Tempest::Matrix4x4>& tr);
 
     bool           isTargeted(Npc& npc);
     Npc*           findHero();
@@ -65,6 +79,10 @@ class WorldObjects final {
     void           detectNpcNear(const std::function<void(Npc&)>& f);
     void           detectNpc (const float x, const float y, const float z, const float r, const std::function<void(Npc&)>&  f);
     void           detectItem(const float x, const float y, const float z, const float r, const std::function<void(Item&)>& f);
+    void           updateNpcIndex(const Npc& npc);
+
+    bool           testLos   (const Npc& src, const Npc& dst, uint8_t point, const Tempest::Vec3& from, const Tempest::Vec3& to);
+    void           requestLos(const Npc& src, const Npc& dst, uint8_t point, const Tempest::Vec3& from, const Tempest::Vec3& to);
 
     uint32_t       npcId(const Npc *ptr) const;
     size_t         npcCount()    const { return npcArr.size(); }
@@ -111,7 +129,9 @@ class WorldObjects final {
     void           addInteractive(Interactive*         obj);
     void           addStatic     (StaticObj*           obj);
     void           addRoot       (const std::shared_ptr<zenkit::VirtualObject>& vob, bool startup);
+    void           captureBaseline();
     void           invalidateVobIndex();
+    void           updateVobIndex(const Vob& vob);
 
     Interactive*   validateInteractive(Interactive *def);
     Npc*           validateNpc        (Npc         *def);
@@ -153,6 +173,25 @@ class WorldObjects final {
       uint64_t timeUntil = 0;
       };
 
+    enum { LosCacheTime = 100 };
+    struct LosKey {
+      const Npc* src   = nullptr;
+      const Npc* dst   = nullptr;
+      uint8_t    point = 0;
+      bool operator == (const LosKey& other) const = default;
+      };
+    struct LosKeyHash {
+      size_t operator()(const LosKey& k) const;
+      };
+    struct LosEntry {
+      uint64_t time    = 0;
+      bool     blocked = false;
+      };
+    struct LosRequest {
+      LosKey        key;
+      Tempest::Vec3 from, to;
+      };
+
     World&                             owner;
 
     std::vector<CollisionZone*>        collisionZn;
@@ -163,14 +202,31 @@ class WorldObjects final {
 
     std::vector<StaticObj*>            objStatic;
     std::vector<std::unique_ptr<Item>> itemArr;
+    std::vector<std::vector<uint8_t>>  zenItemBase;
     std::list<MobStates>               routines;
 
     std::list<Bullet>                  bullets;
     std::vector<EffectState>           effects;
 
     std::vector<std::unique_ptr<Npc>>  npcArr;
+    SpatialHash                        npcIndex;
     std::vector<std::unique_ptr<Npc>>  npcInvalid;
     std::vector<Npc*>                  npcNear;
+    std::vector<Npc*>                  npcActive; // everything, that may have policy other than AiFar2
+    std::vector<Npc*>                  npcSearch;
+    std::vector<NpcCommands>           npcCmd;
+
+    std::vector<uint8_t>               animLod;
+    uint32_t                           animLodCount[AL_Count] = {};
+    uint64_t                           animLodFrame = 0;
+
+    std::unordered_map<const void*,uint32_t> snapIndex;
+    uint64_t                           snapId = 0;
+
+    std::unordered_map<LosKey,LosEntry,LosKeyHash> losCache;
+    std::unordered_set<LosKey,LosKeyHash> losQueued;
+    std::vector<LosRequest>            losPending;
+    std::vector<Npc*>                  losObservers;
 
     std::vector<AbstractTrigger*>      triggers;
     std::vector<AbstractTrigger*>      triggersTk;
@@ -190,7 +246,14 @@ class WorldObjects final {
     void             setMobState(std::string_view scheme, int32_t st);
     void             passivePerceptionProcess(PerceptionMsg& msg, Npc& npc, Npc& pl);
 
+    void             tickNpcParallel(uint64_t dt, uint64_t dtPlayer, bool freeCam);
+    void             classifyNpc(Npc& pl, const Tempest::Vec3& camPos);
     void             tickNear(uint64_t dt);
+    void             tickLos(Npc& pl);
+    void             traceLos(uint64_t now);
     void             tickTriggers(uint64_t dt);
     static bool      isTargetedBy(Npc& npc,Npc& by);
+    auto             itemState(const Item& it) const -> std::vector<uint8_t>;
+    std::string_view itemInstance(const Item& it) const;
+    void             loadZenItems(Serialize& fin);
   };
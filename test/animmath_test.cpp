@@ -0,0 +1,118 @@
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#include "graphics/mesh/animmath.h"
+
+static int failed = 0;
+
+static void check(bool cond, const char* what) {
+  if(cond)
+    return;
+  std::printf("FAILED: %s\n", what);
+  ++failed;
+  }
+
+static void put(float* s, size_t stride, size_t i, const zenkit::AnimationSample& smp) {
+  s[0*stride+i] = smp.position.x;
+  s[1*stride+i] = smp.position.y;
+  s[2*stride+i] = smp.position.z;
+  s[3*stride+i] = smp.rotation.x;
+  s[4*stride+i] = smp.rotation.y;
+  s[5*stride+i] = smp.rotation.z;
+  s[6*stride+i] = smp.rotation.w;
+  }
+
+static glm::quat quat(const float* s, size_t stride, size_t i) {
+  glm::quat q;
+  q.x = s[3*stride+i];
+  q.y = s[4*stride+i];
+  q.z = s[5*stride+i];
+  q.w = s[6*stride+i];
+  return q;
+  }
+
+static glm::quat randomQuat(std::mt19937& rng) {
+  std::normal_distribution<float> n;
+  return glm::normalize(glm::quat(n(rng),n(rng),n(rng),n(rng)));
+  }
+
+// angle between two rotations, in degrees
+static float angle(const glm::quat& a, const glm::quat& b) {
+  const float d = std::min(std::abs(glm::dot(a,b)),1.f);
+  return 2.f*std::acos(d)*180.f/float(M_PI);
+  }
+
+// mixSamples against glm::slerp over the full range of angles and blend factors
+static void mixVsSlerp() {
+  const size_t Lanes = 64, Stride = Lanes+4;
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> pos(-100,100), t(0,1);
+
+  float maxErr = 0, maxPos = 0;
+  for(int iter=0; iter<2000; ++iter) {
+    float x[SamplePlanes*Stride] = {}, y[SamplePlanes*Lanes] = {}, out[SamplePlanes*Stride] = {};
+    zenkit::AnimationSample sx[Lanes], sy[Lanes];
+    for(size_t i=0; i<Lanes; ++i) {
+      sx[i].position = glm::vec3(pos(rng),pos(rng),pos(rng));
+      sy[i].position = glm::vec3(pos(rng),pos(rng),pos(rng));
+      sx[i].rotation = randomQuat(rng);
+      // small steps, as between keyframes, and wide ones, as in layer blends
+      sy[i].rotation = (i%2==0) ? randomQuat(rng) : glm::normalize(sx[i].rotation + 0.05f*randomQuat(rng));
+      put(x,Stride,i,sx[i]);
+      put(y,Lanes, i,sy[i]);
+      }
+
+    const float a = (iter%10==0) ? float(iter%20)/19.f : t(rng);
+    mixSamples(x,Stride,y,Lanes,a,out,Stride,Lanes);
+    for(size_t i=0; i<Lanes; ++i) {
+      const auto ref = mix(sx[i],sy[i],a);
+      maxErr = std::max(maxErr,angle(ref.rotation,quat(out,Stride,i)));
+      maxPos = std::max(maxPos,std::abs(ref.position.x-out[0*Stride+i]));
+      maxPos = std::max(maxPos,std::abs(ref.position.y-out[1*Stride+i]));
+      maxPos = std::max(maxPos,std::abs(ref.position.z-out[2*Stride+i]));
+      }
+    }
+  std::printf("mixSamples vs glm::slerp: max error %f deg, position %f\n", double(maxErr), double(maxPos));
+  check(maxErr<0.1f, "mixSamples rotation");
+  check(maxPos<1e-3f, "mixSamples position");
+  }
+
+static void selectAndMatrices() {
+  const size_t Lanes = 8;
+  std::mt19937 rng(2);
+  float    s[SamplePlanes*Lanes] = {}, out[SamplePlanes*Lanes] = {};
+  uint32_t mask[Lanes] = {};
+  zenkit::AnimationSample smp[Lanes];
+  for(size_t i=0; i<Lanes; ++i) {
+    smp[i].position = glm::vec3(float(i),2.f*float(i),-float(i));
+    smp[i].rotation = randomQuat(rng);
+    put(s,Lanes,i,smp[i]);
+    for(size_t p=0; p<SamplePlanes; ++p)
+      out[p*Lanes+i] = -1.f;
+    mask[i] = (i%3==0) ? ~0u : 0u;
+    }
+
+  selectSamples(s,Lanes,mask,out,Lanes,Lanes);
+  bool ok = true;
+  for(size_t i=0; i<Lanes; ++i)
+    for(size_t p=0; p<SamplePlanes; ++p)
+      ok &= out[p*Lanes+i]==(mask[i] ? s[p*Lanes+i] : -1.f);
+  check(ok, "selectSamples");
+
+  Tempest::Matrix4x4 m[Lanes];
+  mkMatrices(s,Lanes,Lanes,m);
+  ok = true;
+  for(size_t i=0; i<Lanes; ++i) {
+    const auto ref = mkMatrix(smp[i]);
+    for(size_t k=0; k<16; ++k)
+      ok &= std::abs(ref.data()[k]-m[i].data()[k])<1e-5f;
+    }
+  check(ok, "mkMatrices");
+  }
+
+int main() {
+  mixVsSlerp();
+  selectAndMatrices();
+  return failed==0 ? 0 : 1;
+  }
@@ -0,0 +1,86 @@
+#include <Tempest/TextCodec>
+
+#include <filesystem>
+#include <cstdio>
+
+#include "utils/assetcache.h"
+
+using TextureBlob = AssetCache::TextureBlob;
+
+static int failed = 0;
+
+static void check(bool cond, const char* what) {
+  if(cond)
+    return;
+  std::printf("FAILED: %s\n", what);
+  ++failed;
+  }
+
+// same path as Resources::decodeTexture: encode -> save -> load -> decode
+static void roundTrip(const AssetCache& cache, const char* name, uint8_t type, uint32_t w, uint32_t h,
+                      const std::vector<uint8_t>& data) {
+  TextureBlob src;
+  src.type   = type;
+  src.width  = w;
+  src.height = h;
+  src.data   = data;
+
+  AssetCache::Writer wr;
+  AssetCache::writeTexture(wr,src);
+  cache.save(AssetCache::K_Texture,name,wr);
+
+  AssetCache::Reader rd;
+  TextureBlob        dst;
+  check(cache.load(AssetCache::K_Texture,name,rd), name);
+  check(AssetCache::readTexture(rd,dst),           name);
+  check(dst.type==type && dst.width==w && dst.height==h, name);
+  check(dst.data.size()==data.size() && std::equal(data.begin(),data.end(),dst.data.begin()), name);
+  }
+
+int main(int argc, char** argv) {
+  const auto dir = std::filesystem::path(argc>1 ? argv[1] : "assetcache");
+  std::filesystem::remove_all(dir);
+
+  AssetCache cache;
+  cache.setup(dir.u16string()+u"/", 0x1234);
+  check(cache.isEnabled(), "setup");
+
+  std::vector<uint8_t> dds(128+64);
+  for(size_t i=0; i<dds.size(); ++i)
+    dds[i] = uint8_t(i*7);
+  std::memcpy(dds.data(), "DDS ", 4);
+  roundTrip(cache, "TEST-C.TEX",  TextureBlob::Dds,  8, 8, dds);
+
+  std::vector<uint8_t> rgba(5*3*4);
+  for(size_t i=0; i<rgba.size(); ++i)
+    rgba[i] = uint8_t(255-i);
+  roundTrip(cache, "TEST2-C.TEX", TextureBlob::Rgba, 5, 3, rgba);
+
+  // raw pixels of wrong size must not be accepted
+  {
+  TextureBlob bad;
+  bad.type   = TextureBlob::Rgba;
+  bad.width  = 4;
+  bad.height = 4;
+  bad.data   = rgba;
+  AssetCache::Writer wr;
+  AssetCache::writeTexture(wr,bad);
+  cache.save(AssetCache::K_Texture,"BAD-C.TEX",wr);
+
+  AssetCache::Reader rd;
+  TextureBlob        dst;
+  check(cache.load(AssetCache::K_Texture,"BAD-C.TEX",rd), "bad size load");
+  check(!AssetCache::readTexture(rd,dst),                 "bad size rejected");
+  }
+
+  // other archive set: stale entries are ignored
+  AssetCache other;
+  other.setup(dir.u16string()+u"/", 0x4321);
+  AssetCache::Reader rd;
+  check(!other.load(AssetCache::K_Texture,"TEST-C.TEX",rd), "fingerprint");
+
+  std::filesystem::remove_all(dir);
+  if(failed==0)
+    std::printf("OK\n");
+  return failed==0 ? 0 : 1;
+  }
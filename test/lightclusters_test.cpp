@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#include "graphics/lightclusters.h"
+
+struct Vec {
+  float x = 0, y = 0, z = 0;
+  };
+
+struct Light {
+  Vec   at;
+  float r = 0;
+  };
+
+struct Camera {
+  float zNear  = 10;
+  float zFar   = 5000;
+  float fov    = 1.2f;
+  float aspect = 16.f/9.f;
+  float view[16] = {};
+  float vp  [16] = {};
+  };
+
+// column-major, same as Tempest::Matrix4x4
+static void mul(const float a[16], const float b[16], float out[16]) {
+  for(int c=0; c<4; ++c)
+    for(int r=0; r<4; ++r) {
+      float s = 0;
+      for(int k=0; k<4; ++k)
+        s += a[k*4+r]*b[c*4+k];
+      out[c*4+r] = s;
+      }
+  }
+
+static Camera mkCamera(float yaw) {
+  Camera cam;
+  const float t  = 1.f/std::tan(cam.fov/2);
+  const float c  = std::cos(yaw), s = std::sin(yaw);
+  const float zn = cam.zNear, zf = cam.zFar;
+
+  const float proj[16] = {t/cam.aspect,0,0,0, 0,t,0,0, 0,0,(zf+zn)/(zn-zf),-1, 0,0,2*zf*zn/(zn-zf),0};
+  const float rot [16] = {c,0,s,0, 0,1,0,0, -s,0,c,0, 0,0,0,1};
+  const float tr  [16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, -100,-20,300,1};
+  mul(rot,tr,cam.view);
+  mul(proj,cam.view,cam.vp);
+  return cam;
+  }
+
+static Vec toView(const Camera& cam, const Vec& p) {
+  const float* m = cam.view;
+  return Vec{m[0]*p.x + m[4]*p.y + m[8] *p.z + m[12],
+             m[1]*p.x + m[5]*p.y + m[9] *p.z + m[13],
+             m[2]*p.x + m[6]*p.y + m[10]*p.z + m[14]};
+  }
+
+static float qDist(const Vec& a, const Vec& b) {
+  const float dx = a.x-b.x, dy = a.y-b.y, dz = a.z-b.z;
+  return dx*dx + dy*dy + dz*dz;
+  }
+
+static float dot(const Vec& a, const Vec& b) {
+  return a.x*b.x + a.y*b.y + a.z*b.z;
+  }
+
+static Vec sub(const Vec& a, const Vec& b) {
+  return Vec{a.x-b.x, a.y-b.y, a.z-b.z};
+  }
+
+static Vec cross(const Vec& a, const Vec& b) {
+  return Vec{a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x};
+  }
+
+// cluster as view-space box of ndc-range and depth range, independent from clip-planes of LightClusters
+struct Cluster {
+  float x0 = 0, x1 = 0, y0 = 0, y1 = 0, d0 = 0, d1 = 0;
+
+  // u,v,s in [0,1]: ndc.x, ndc.y and depth inside of the cluster
+  Vec point(const Camera& cam, float u, float v, float s) const {
+    const float t = 1.f/std::tan(cam.fov/2);
+    const float w = d0 + (d1-d0)*s;
+    const float x = x0 + (x1-x0)*u;
+    const float y = y0 + (y1-y0)*v;
+    return Vec{x*w*cam.aspect/t, y*w/t, -w};
+    }
+
+  bool contains(const Camera& cam, const Vec& p) const {
+    const float t = 1.f/std::tan(cam.fov/2);
+    const float w = -p.z;
+    if(w<d0 || w>d1)
+      return false;
+    const float x = p.x*t/(cam.aspect*w);
+    const float y = p.y*t/w;
+    return x0<=x && x<=x1 && y0<=y && y<=y1;
+    }
+
+  // smallest signed distance to 6 faces, built from corner points; positive inside
+  float faceDist(const Camera& cam, const Vec& p) const {
+    const Vec center = point(cam,0.5f,0.5f,0.5f);
+    float     ret    = 0;
+    for(int f=0; f<6; ++f) {
+      const float e = float(f&1);
+      Vec a, b, c;
+      switch(f/2) {
+        case 0: a = point(cam,e,0,0); b = point(cam,e,1,0); c = point(cam,e,0,1); break;
+        case 1: a = point(cam,0,e,0); b = point(cam,1,e,0); c = point(cam,0,e,1); break;
+        case 2: a = point(cam,0,0,e); b = point(cam,1,0,e); c = point(cam,0,1,e); break;
+        }
+      Vec n = cross(sub(b,a),sub(c,a));
+      const float len = std::sqrt(dot(n,n));
+      n = Vec{n.x/len, n.y/len, n.z/len};
+      if(dot(n,sub(center,a))<0)
+        n = Vec{-n.x, -n.y, -n.z};
+      const float d = dot(n,sub(p,a));
+      ret = (f==0 ? d : std::min(ret,d));
+      }
+    return ret;
+    }
+
+  // sufficient for intersection: center inside, or some point of boundary (sampled on grid) inside of sphere
+  bool mustHit(const Camera& cam, const Vec& p, float r) const {
+    if(contains(cam,p))
+      return true;
+    const int n = 8;
+    for(int f=0; f<6; ++f)
+      for(int i=0; i<=n; ++i)
+        for(int j=0; j<=n; ++j) {
+          const float a = float(i)/n, b = float(j)/n, e = float(f&1);
+          Vec s;
+          switch(f/2) {
+            case 0: s = point(cam,e,a,b); break;
+            case 1: s = point(cam,a,e,b); break;
+            case 2: s = point(cam,a,b,e); break;
+            }
+          if(qDist(s,p)<r*r)
+            return true;
+          }
+    return false;
+    }
+  };
+
+// every light, that touches a cluster, must be listed;
+// listing must match sphere-vs-face test against cluster built from its corner points
+static size_t check(uint32_t sx, uint32_t sy, uint32_t sz, float yaw, uint32_t seed, size_t count) {
+  const auto cam = mkCamera(yaw);
+
+  std::mt19937                          rng(seed);
+  std::uniform_real_distribution<float> pos(-3000,3000), range(5,800);
+  std::vector<Light> light(count);
+  std::vector<Vec>   lightV(count);
+  for(size_t i=0; i<count; ++i) {
+    light[i]  = {Vec{pos(rng), pos(rng)*0.3f, pos(rng)}, range(rng)};
+    lightV[i] = toView(cam,light[i].at);
+    }
+
+  LightClusters lc(sx,sy,sz);
+  lc.begin(cam.vp,cam.zNear,cam.zFar);
+  for(uint32_t i=0; i<light.size(); ++i)
+    lc.add(light[i].at.x,light[i].at.y,light[i].at.z,light[i].r,i);
+  lc.end();
+
+  size_t missed = 0, mismatch = 0;
+  for(uint32_t z=0; z<sz; ++z)
+    for(uint32_t y=0; y<sy; ++y)
+      for(uint32_t x=0; x<sx; ++x) {
+        Cluster cl;
+        cl.d0 = cam.zNear*std::pow(cam.zFar/cam.zNear, float(z  )/float(sz));
+        cl.d1 = cam.zNear*std::pow(cam.zFar/cam.zNear, float(z+1)/float(sz));
+        cl.x0 = -1.f+2.f*float(x)/float(sx), cl.x1 = -1.f+2.f*float(x+1)/float(sx);
+        cl.y0 = -1.f+2.f*float(y)/float(sy), cl.y1 = -1.f+2.f*float(y+1)/float(sy);
+
+        auto& c   = lc.clusters()[lc.clusterId(x,y,z)];
+        auto  got = std::vector<uint32_t>(lc.indices().begin()+c.offset, lc.indices().begin()+c.offset+c.count);
+        std::sort(got.begin(),got.end());
+
+        for(uint32_t i=0; i<light.size(); ++i) {
+          const bool  listed = std::binary_search(got.begin(),got.end(),i);
+          const float margin = cl.faceDist(cam,lightV[i]) + light[i].r;
+          // float rounding of two different derivations: ignore lights touching a face
+          if(std::abs(margin)>1e-3f*light[i].r && listed!=(margin>0))
+            ++mismatch;
+          if(!listed && cl.mustHit(cam,lightV[i],light[i].r))
+            ++missed;
+          }
+        }
+  std::printf("grid %ux%ux%u, %zu lights: %zu missed, %zu mismatched\n", sx, sy, sz, count, missed, mismatch);
+  return missed+mismatch;
+  }
+
+int main() {
+  size_t bad = 0;
+  bad += check(16, 9,24, 0.7f, 1, 2000);
+  bad += check(32,32,32,-2.1f, 2,  500);
+  bad += check( 1, 1, 1, 0.0f, 3,  100);
+  bad += check( 7, 5,13, 3.0f, 4, 1000);
+
+  // tile masks are 32 bit wide: larger grids are reported and clamped
+  LightClusters big(40,33,8);
+  if(big.sizeX()!=LightClusters::MaxTiles || big.sizeY()!=LightClusters::MaxTiles) {
+    std::printf("grid 40x33x8: not clamped to %u tiles\n", LightClusters::MaxTiles);
+    ++bad;
+    }
+  return bad==0 ? 0 : 1;
+  }